@@ -1,6 +1,6 @@
 #!/bin/bash
 
-read -p "Enter 'sim', 'game', 'cite', 'server', 'client', or 'PredPreySim', 'Snakes': " file
+read -p "Enter 'sim', 'game', 'cite', 'server', 'client', 'PredPreySim', 'Snakes', or 'test': " file
 
 if [ -z "$file" ]; then
     echo "No input provided. Exiting."
@@ -17,15 +17,30 @@ compile_and_run() {
     fi
 }
 
+run_test() {
+    gcc $CFLAGS "$1" -o "$2" "${@:3}"
+    if [ $? -eq 0 ] && ./"$2"; then
+        echo "PASS $2"
+    else
+        echo "FAIL $2"
+        failed=1
+    fi
+    rm -f "$2"
+}
+
+CFLAGS="${CFLAGS:--O3 -fno-math-errno}"
+
+predprey_sources=("utils/environment.c" "utils/Random/rng.c" "utils/NNS/NN.c" "utils/NNS/NN_quant.c" "utils/NNS/NN_population.c" "utils/NNS/NN_model.c" "utils/NNS/NN_learner.c" "utils/NNS/NN_codegen.c" "utils/Evolution/genetic.c" "utils/Evolution/evolution.c" "utils/Evolution/genome.c" "utils/Evolution/island.c" "utils/Evolution/steady.c" "utils/Evolution/checkpoint.c" "utils/Concurrency/thread_pool.c" "utils/Concurrency/process_pool.c" "utils/Concurrency/ring_buffer.c" "utils/Telemetry/telemetry.c" "utils/Spatial/proximity.c" "-pthread" "-lm" "-ldl" "-framework" "CoreFoundation" "-framework" "CoreGraphics")
+
 host="127.0.0.1"
 port="42069"
 
 case "$file" in
   "game")
-    compile_and_run "src/game.c" "game" "utils/environment.c" "utils/type_system/type_system.c" utils/NNS/NN.c "-lpthread" "-framework" "CoreFoundation" "-framework" "CoreGraphics"
+    compile_and_run "src/game.c" "game" "utils/environment.c" "utils/Random/rng.c" "utils/type_system/type_system.c" utils/NNS/NN.c "-lpthread" "-framework" "CoreFoundation" "-framework" "CoreGraphics"
     ;;
   "sim")
-    compile_and_run "src/sim.c" "sim" "utils/environment.c" "utils/NN.c" "utils/type_system/type_system.c" "-lpthread" "-lm" "-framework" "CoreFoundation" "-framework" "CoreGraphics"
+    compile_and_run "src/sim.c" "sim" "utils/environment.c" "utils/Random/rng.c" "utils/NN.c" "utils/type_system/type_system.c" "-lpthread" "-lm" "-framework" "CoreFoundation" "-framework" "CoreGraphics"
     ;;
   "cite")
     gcc "src/cite.c" -o "cite" "utils/socketed/cite.c" "utils/socketed/protocol.c" "-pthread" "-lm" "-framework" "CoreFoundation" "-framework" "CoreGraphics"
@@ -37,7 +52,7 @@ case "$file" in
     fi
     ;;
   "server")
-    gcc "utils/socketed/server.c" -o "server" "utils/environment.c" "utils/Concurrency/thread_pool.c" "-pthread" "-lm" "-framework" "CoreFoundation" "-framework" "CoreGraphics"
+    gcc "utils/socketed/server.c" -o "server" "utils/environment.c" "utils/Random/rng.c" "utils/Concurrency/thread_pool.c" "-pthread" "-lm" "-framework" "CoreFoundation" "-framework" "CoreGraphics"
     if [ $? -eq 0 ]; then
         ./server "$host" "$port"
         rm "server"
@@ -46,7 +61,7 @@ case "$file" in
     fi
     ;;
   "client")
-    gcc "utils/socketed/client.c" -o "client" "utils/environment.c" "utils/Concurrency/thread_pool.c" "-pthread" "-lm" "-framework" "CoreFoundation" "-framework" "CoreGraphics"
+    gcc "utils/socketed/client.c" -o "client" "utils/environment.c" "utils/Random/rng.c" "utils/Concurrency/thread_pool.c" "-pthread" "-lm" "-framework" "CoreFoundation" "-framework" "CoreGraphics"
     if [ $? -eq 0 ]; then
         ./client "$host" "$port"
         rm "client"
@@ -55,7 +70,7 @@ case "$file" in
     fi
     ;;
   "PredPreySim")
-   gcc "src/PredPreySim.c" -o "PredPreySim" "utils/environment.c" "utils/NNS/NN.c" "-pthread" "-lm" "-framework" "CoreFoundation" "-framework" "CoreGraphics"
+   gcc $CFLAGS "src/PredPreySim.c" -o "PredPreySim" "${predprey_sources[@]}"
    if [ $? -eq 0 ]; then
      ./PredPreySim
      rm PredPreySim
@@ -64,7 +79,7 @@ case "$file" in
   fi
     ;;
   "Snakes")
-   gcc "src/Snakes.c" -o "Snakes" "utils/environment.c" "utils/NNS/NN.c" "-pthread" "-lm" "-framework" "CoreFoundation" "-framework" "CoreGraphics" 
+   gcc "src/Snakes.c" -o "Snakes" "utils/environment.c" "utils/Random/rng.c" "utils/NNS/NN.c" "-pthread" "-lm" "-framework" "CoreFoundation" "-framework" "CoreGraphics" 
    if [ $? -eq 0 ]; then
      ./Snakes
      rm Snakes
@@ -72,6 +87,20 @@ case "$file" in
      echo "Compilation failed for Snakes."
    fi
     ;;
+  "test")
+    failed=0
+    run_test "tests/test_parallel.c" "test_parallel" "utils/NNS/NN.c" "utils/NNS/NN_parallel.c" "utils/Random/rng.c" "utils/Concurrency/thread_pool.c" "-pthread" "-lm"
+    run_test "tests/test_precision.c" "test_precision" "utils/NNS/NN.c" "utils/Random/rng.c" "-lm"
+    run_test "tests/test_model.c" "test_model" "utils/NNS/NN.c" "utils/NNS/NN_model.c" "utils/NNS/NN_population.c" "utils/Random/rng.c" "-lm"
+    run_test "tests/test_population.c" "test_population" "utils/NNS/NN.c" "utils/NNS/NN_population.c" "utils/Random/rng.c" "-lm"
+    run_test "tests/test_conv.c" "test_conv" "utils/NNS/NN.c" "utils/NNS/NN_conv.c" "utils/Random/rng.c" "-lm"
+    run_test "tests/test_evolution.c" "test_evolution" "utils/Evolution/evolution.c" "utils/Evolution/genetic.c" "utils/Random/rng.c" "utils/Concurrency/thread_pool.c" "-pthread" "-lm"
+    run_test "tests/test_ring_buffer.c" "test_ring_buffer" "utils/Concurrency/ring_buffer.c" "-pthread"
+    run_test "tests/test_codegen.c" "test_codegen" "utils/NNS/NN.c" "utils/NNS/NN_codegen.c" "utils/NNS/NN_model.c" "utils/Random/rng.c" "-lm" "-ldl"
+    run_test "tests/test_generations.c" "test_generations" "${predprey_sources[@]}"
+    run_test "tests/test_checkpoint.c" "test_checkpoint" "${predprey_sources[@]}"
+    exit $failed
+    ;;
   *)
     echo "Invalid Option: $file"
     exit 1
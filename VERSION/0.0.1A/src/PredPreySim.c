@@ -5,22 +5,66 @@
 #include <signal.h>
 #include <unistd.h>
 #include <math.h>
+#include <stddef.h>
+#include <sys/wait.h>
 #include "../utils/environment.h"
 #include "../utils/NNs/NN.h"
+#include "../utils/NNS/NN_quant.h"
+#include "../utils/NNS/NN_population.h"
+#include "../utils/NNS/NN_model.h"
+#include "../utils/NNS/NN_learner.h"
+#include "../utils/NNS/NN_codegen.h"
+#include "../utils/Random/rng.h"
+#include "../utils/Evolution/evolution.h"
+#include "../utils/Evolution/island.h"
+#include "../utils/Evolution/steady.h"
+#include "../utils/Evolution/checkpoint.h"
+#include "../utils/Concurrency/thread_pool.h"
+#include "../utils/Concurrency/process_pool.h"
+#include "../utils/Telemetry/telemetry.h"
+#include "../utils/Spatial/proximity.h"
 
 #define FPS 120 
-#define MAX_AGENTS 10
-#define MAX_PREDATORS 5
-#define MAX_PREY 10 
+#define INITIAL_PREDATORS 5
+#define INITIAL_PREY 10
 #define MAX_FOOD 15
 #define INITIAL_HEALTH 1000
 #define HEALTH_DECAY_RATE 0 
-#define CATCH_DISTANCE 1 
 #define PREDATOR_GAIN 100 
 #define PREY_GAIN 100 
-#define FOOD_RESPAWN_RATE 0.02
+#define CATCH_RADIUS 0 /* cells; 0 catches only on a shared cell */
+#define PROXIMITY_BLOCK 256
+#define FOOD_RESPAWN_RATE 0.02 /* expected spawns per world per tick, may exceed 1 */
 #define MUTATION_RATE 1 
+#define MUTATION_STDDEV 0.03
+#define TOURNAMENT_SIZE 3
+#define ELITES 1
+#define MIGRANTS 2
 #define CROSSOVER_RATE 0.1 
+#define QUANTIZED_POLICY 0
+#define WORLDS 1
+#define THREADS 0 /* 0: one per core */
+#define STEADY_POPULATION 32
+#define EPISODE_TICKS 2000
+#define STAGNATION_TICKS 200
+#define BRAIN_HIDDEN 20
+#define BRAIN_LEARNING_RATE 0.01 /* inline backprop step */
+#define BRAIN_MOMENTUM 0.9
+#define LEARNER_RATE 0.001
+#define LEARNER_EPSILON 0.05
+#define TELEMETRY_INTERVAL 600 /* ticks per telemetry record */
+#define TELEMETRY_CAPACITY 256
+#define CHECKPOINT_INTERVAL 6000 /* ticks between automatic checkpoints */
+#define SWEEP_EVALUATIONS 100 /* steady-state evaluations per species per sweep job */
+#define SWEEP_RESULTS "sweep.csv"
+#define COMPILED_SYMBOL "predPreyBrain"
+#define COMPILE_SAMPLES 64
+#define QUANTIZE_SAMPLES 256
+#define VISION_RADIUS 4
+#define VISION_SIZE (2 * VISION_RADIUS + 1)
+#define VISION_CELLS (VISION_SIZE * VISION_SIZE)
+#define VISION_CHANNELS 4 /* 4: predator/prey/food/wall planes, 1: one plane of cell codes */
+#define VISION_INPUTS (VISION_CHANNELS * VISION_CELLS)
 
 typedef enum {
   UP,
@@ -32,373 +76,1833 @@ typedef enum {
 
 Direction Directions[NUM_DIRECTIONS] = {UP, DOWN, LEFT, RIGHT};
 
+/*
+ * Tunables read at runtime, defaulting to the #defines above. They are set
+ * once before any simulation starts, from --set or a sweep job, and are
+ * read-only afterwards.
+ */
 typedef struct {
-    NN_t *nn;
-    Entity *entity;
-    double fitness;
-    size_t is_predator;
-    size_t time_alive;
-    Direction dir;
-} Agent;
+    double initialPredators;
+    double initialPrey;
+    double maxFood;
+    double initialHealth;
+    double healthDecayRate;
+    double predatorGain;
+    double preyGain;
+    double catchRadius;
+    double foodRespawnRate;
+    double mutationRate;
+    double mutationStddev;
+    double tournamentSize;
+    double elites;
+    double crossoverRate;
+    double steadyPopulation;
+    double episodeTicks;
+    double stagnationTicks;
+    double learnerRate;
+    double learnerEpsilon;
+} SimulationParams;
+
+static SimulationParams params = {
+    .initialPredators = INITIAL_PREDATORS,
+    .initialPrey = INITIAL_PREY,
+    .maxFood = MAX_FOOD,
+    .initialHealth = INITIAL_HEALTH,
+    .healthDecayRate = HEALTH_DECAY_RATE,
+    .predatorGain = PREDATOR_GAIN,
+    .preyGain = PREY_GAIN,
+    .catchRadius = CATCH_RADIUS,
+    .foodRespawnRate = FOOD_RESPAWN_RATE,
+    .mutationRate = MUTATION_RATE,
+    .mutationStddev = MUTATION_STDDEV,
+    .tournamentSize = TOURNAMENT_SIZE,
+    .elites = ELITES,
+    .crossoverRate = CROSSOVER_RATE,
+    .steadyPopulation = STEADY_POPULATION,
+    .episodeTicks = EPISODE_TICKS,
+    .stagnationTicks = STAGNATION_TICKS,
+    .learnerRate = LEARNER_RATE,
+    .learnerEpsilon = LEARNER_EPSILON,
+};
 
 typedef struct {
-    Entity *entity;
-} Food;
+    const char *name;
+    size_t offset;
+} ParamField;
+
+static const ParamField paramFields[] = {
+    {"initial_predators", offsetof(SimulationParams, initialPredators)},
+    {"initial_prey", offsetof(SimulationParams, initialPrey)},
+    {"max_food", offsetof(SimulationParams, maxFood)},
+    {"initial_health", offsetof(SimulationParams, initialHealth)},
+    {"health_decay_rate", offsetof(SimulationParams, healthDecayRate)},
+    {"predator_gain", offsetof(SimulationParams, predatorGain)},
+    {"prey_gain", offsetof(SimulationParams, preyGain)},
+    {"catch_radius", offsetof(SimulationParams, catchRadius)},
+    {"food_respawn_rate", offsetof(SimulationParams, foodRespawnRate)},
+    {"mutation_rate", offsetof(SimulationParams, mutationRate)},
+    {"mutation_stddev", offsetof(SimulationParams, mutationStddev)},
+    {"tournament_size", offsetof(SimulationParams, tournamentSize)},
+    {"elites", offsetof(SimulationParams, elites)},
+    {"crossover_rate", offsetof(SimulationParams, crossoverRate)},
+    {"steady_population", offsetof(SimulationParams, steadyPopulation)},
+    {"episode_ticks", offsetof(SimulationParams, episodeTicks)},
+    {"stagnation_ticks", offsetof(SimulationParams, stagnationTicks)},
+    {"learner_rate", offsetof(SimulationParams, learnerRate)},
+    {"learner_epsilon", offsetof(SimulationParams, learnerEpsilon)},
+};
+
+#define NUM_PARAMS (sizeof(paramFields) / sizeof(paramFields[0]))
+
+static double *paramValue(SimulationParams *values, size_t field) {
+    return (double *)((char *)values + paramFields[field].offset);
+}
+
+static int findParam(const char *name, size_t length) {
+    for (size_t f = 0; f < NUM_PARAMS; f++) {
+        if (strlen(paramFields[f].name) == length && strncmp(paramFields[f].name, name, length) == 0) return (int)f;
+    }
+    return -1;
+}
+
+/* Applies one NAME=VALUE assignment; returns 0, or -1 for an unknown name or a bad value. */
+int setParam(const char *assignment) {
+    const char *equals = strchr(assignment, '=');
+    int field = equals ? findParam(assignment, (size_t)(equals - assignment)) : -1;
+    char *end = NULL;
+    double value = field >= 0 ? strtod(equals + 1, &end) : 0;
+    if (field < 0 || end == equals + 1 || *end != '\0' || !(value >= 0)) {
+        fprintf(stderr, "Invalid parameter %s\n", assignment);
+        return -1;
+    }
+    *paramValue(&params, (size_t)field) = value;
+    return 0;
+}
 
 typedef struct {
-    Agent *predators[MAX_PREDATORS];
-    Agent *preys[MAX_PREY];
-    Food *foods[MAX_FOOD];
-    size_t numPredators;
-    size_t numPreys;
-    size_t numFoods;
+    unsigned int id;
+    unsigned int count;
+    const char *dir;
+} IslandOptions;
+
+typedef struct {
+    size_t numWorlds;
+    int numThreads;
+    int learn;
+    const char *telemetry;  /* NULL: no telemetry */
+    const char *checkpoint; /* NULL: no checkpoints */
+    const char *resume;     /* checkpoint to start from, or NULL */
+} RunOptions;
+
+/*
+ * Structure-of-arrays agent storage: one column per field, so per-tick
+ * loops stream through memory. Spawning appends and despawning moves the
+ * last agent into the hole, both O(1); columns grow geometrically. Once
+ * bound, the batched brains follow the same moves slot for slot.
+ */
+typedef struct {
+    size_t count;
+    size_t capacity;
+    uint32_t *world;
+    uint8_t *x;
+    uint8_t *y;
+    uint8_t *dir;
+    unsigned int *health;
+    unsigned int *lastHealth; /* health before the current tick */
+    size_t *timeAlive;
+    double *fitness;
+    NN_t **nn;
+    NNQ8_t **policy;
+    Rng *rng;
+    double *vision; /* VISION_INPUTS per agent */
+    uint8_t *acted; /* vision, dir and lastHealth describe a step still to be replayed */
+    NNPopulation *brains;
+    NNLearner *learner; /* when set the species acts with the learner's shared network */
+    const double *learnerParams; /* snapshot acquired for the current tick */
+    char symbol;
+    Color color;
+    int isPredator;
+} Agents;
+
+#define FOOD_NONE UINT32_MAX
+
+/*
+ * Dense food pool with a per-cell index: cells maps every cell of every
+ * world to the food on it, or FOOD_NONE, so at most one food sits on a
+ * cell. Eating swaps the last food into the freed slot and spawning
+ * reuses slots at the end, both O(1).
+ */
+typedef struct {
+    size_t count;
+    size_t capacity;
+    uint32_t *world;
+    uint8_t *x;
+    uint8_t *y;
+    uint32_t *cells;
+} Foods;
+
+typedef struct {
+    struct Simulation *simulation;
+    const Canvas *canvas;
+    size_t begin;
+    size_t end;
+} SimulationWorker;
+
+typedef struct {
+    uint64_t ticks;
+    double predatorBest;
+    double predatorMean;
+    double preyBest;
+    double preyMean;
+} GenerationStats;
+
+/*
+ * A batch of numWorlds independent worlds stepped in lockstep. Agents and
+ * food of every world share the same columns, tagged by world, so one
+ * batched forward pass per species serves the whole batch; worlds only
+ * differ in which occupancy grid they read and who they can catch.
+ *
+ * A tick decides every agent's move in parallel from the frozen occupancy
+ * grid, resolves catches and food on the moved positions, then lets every
+ * agent learn in parallel. Agents only touch their own columns and
+ * network while running in parallel, so results do not depend on the
+ * number of workers.
+ */
+typedef struct Simulation {
+    Agents predators;
+    Agents preys;
+    Foods foods;
+    size_t numWorlds;
+    size_t *worldFoods; /* food count per world */
+    Evolution *evolution;
+    Island *predatorIsland;
+    Island *preyIsland;
+    uint8_t *occupancy; /* numWorlds grids of numRows * numCols OCCUPIED_* bits */
+    uint16_t *predatorCount; /* per cell after moves; zero between ticks */
+    uint16_t *preyCount;
+    uint32_t *firstPrey; /* lowest prey index per cell after moves, UINT32_MAX if none */
+    ThreadPool *pool;
+    SimulationWorker *workers;
+    unsigned int numWorkers;
+    size_t tick;
+    size_t generation; /* restarts so far */
+    Telemetry *telemetry;
+    unsigned int telemetrySource;
+    unsigned int telemetryProducer;
+    size_t catches;    /* since the last telemetry record */
+    size_t foodEaten;
+    size_t reportTick;
+    double reportTime;
+    GenerationStats *history; /* one entry per finished generation */
+    size_t historyCount;
+    size_t historyCapacity;
+    size_t generationStart; /* tick the current generation began */
+    Checkpointer *checkpointer;
+    CheckpointBuffer snapshot;
 } Simulation;
 
-double distance(Pos A, Pos B) {
-    return sqrt(pow(A.x - B.x, 2) + pow(A.y - B.y, 2));
+/* Health saturates at 0: a drained agent is dead, not wrapped round to the fittest. */
+static unsigned int drain(unsigned int health, unsigned int amount) {
+    return health > amount ? health - amount : 0;
 }
-double calculatePredatorFitness(Agent *predator) {
-    return 1 / 1 + predator->entity->health + predator->time_alive;
+
+double calculatePredatorFitness(Agents *predators, size_t i) {
+    return 1 / 1 + predators->health[i] + predators->timeAlive[i];
 }
 
-double calculatePreyFitness(Agent *prey) {
-    return 1 / 1 + prey->entity->health + prey->time_alive; 
+double calculatePreyFitness(Agents *preys, size_t i) {
+    return 1 / 1 + preys->health[i] + preys->timeAlive[i];
 }
 
-double *one_hot_encode(Simulation *simulation, Canvas *canvas) {
-    size_t canvas_size = canvas->numRows * canvas->numCols;
+enum {
+    OCCUPIED_PREDATOR = 1 << 0,
+    OCCUPIED_PREY = 1 << 1,
+    OCCUPIED_FOOD = 1 << 2,
+    OCCUPIED_WALL = 1 << 3,
+};
 
-    double *one_hot_encoded = malloc(canvas_size * sizeof(double)); 
+static size_t cellOf(const Canvas *canvas, uint32_t world, uint8_t x, uint8_t y) {
+    return ((size_t)world * canvas->numRows + y) * canvas->numCols + x;
+}
 
-    memset(one_hot_encoded, 0, canvas_size * sizeof(double)); 
-  
-    for (size_t i = 0; i < simulation->numPredators; i++) {
-        one_hot_encoded[canvas_size - simulation->predators[i]->entity->cell.pos.y * canvas->numCols + simulation->predators[i]->entity->cell.pos.x] = 1;
+void markOccupancy(uint8_t *occupancy, const uint32_t *worlds, const uint8_t *xs, const uint8_t *ys, size_t count, const Canvas *canvas, uint8_t bit) {
+    for (size_t i = 0; i < count; i++) {
+        occupancy[cellOf(canvas, worlds[i], xs[i], ys[i])] |= bit;
     }
-  
-    for (size_t i = 0; i < simulation->numPreys; i++) {
-        one_hot_encoded[canvas_size - simulation->preys[i]->entity->cell.pos.y * canvas->numCols + simulation->preys[i]->entity->cell.pos.x] = 3;
+}
+
+void buildOccupancy(Simulation *simulation, Canvas *canvas) {
+    memset(simulation->occupancy, 0, simulation->numWorlds * canvas->numRows * canvas->numCols);
+    markOccupancy(simulation->occupancy, simulation->predators.world, simulation->predators.x, simulation->predators.y, simulation->predators.count, canvas, OCCUPIED_PREDATOR);
+    markOccupancy(simulation->occupancy, simulation->preys.world, simulation->preys.x, simulation->preys.y, simulation->preys.count, canvas, OCCUPIED_PREY);
+    markOccupancy(simulation->occupancy, simulation->foods.world, simulation->foods.x, simulation->foods.y, simulation->foods.count, canvas, OCCUPIED_FOOD);
+}
+
+static void seeCell(double *vision, size_t cell, uint8_t occupied) {
+#if VISION_CHANNELS == 1
+    vision[cell] = occupied & OCCUPIED_WALL ? -1 : occupied & OCCUPIED_PREY ? 3 : occupied & OCCUPIED_FOOD ? 2 : 1;
+#else
+    for (size_t c = 0; c < VISION_CHANNELS; c++) {
+        if (occupied & (1u << c)) {
+            vision[c * VISION_CELLS + cell] = 1;
+        }
     }
-  
-    for (size_t i = 0; i < simulation->numFoods; i++) {
-        one_hot_encoded[canvas_size - simulation->foods[i]->entity->cell.pos.y * canvas->numCols + simulation->foods[i]->entity->cell.pos.x] = 2;
+#endif
+}
+
+/*
+ * Copies the VISION_SIZE x VISION_SIZE window centred on (x, y) out of the
+ * occupancy grid, channel-major. The border and anything past it reads as wall.
+ */
+void observe(const uint8_t *occupancy, const Canvas *canvas, int x, int y, double *vision) {
+    memset(vision, 0, sizeof(double) * VISION_INPUTS);
+    for (int dy = -VISION_RADIUS; dy <= VISION_RADIUS; dy++) {
+        int row = y + dy;
+        for (int dx = -VISION_RADIUS; dx <= VISION_RADIUS; dx++) {
+            int col = x + dx;
+            size_t cell = (size_t)(dy + VISION_RADIUS) * VISION_SIZE + (size_t)(dx + VISION_RADIUS);
+            if (row < 1 || col < 1 || row >= canvas->numRows - 1 || col >= canvas->numCols - 1) {
+                seeCell(vision, cell, OCCUPIED_WALL);
+            } else if (occupancy[row * canvas->numCols + col]) {
+                seeCell(vision, cell, occupancy[row * canvas->numCols + col]);
+            }
+        }
+    }
+}
+
+static int growColumn(void **column, size_t elementSize, size_t capacity) {
+    void *grown = realloc(*column, elementSize * capacity);
+    if (!grown) return 0;
+    *column = grown;
+    return 1;
+}
+
+int reserveAgents(Agents *agents, size_t capacity) {
+    if (capacity <= agents->capacity) return 1;
+    if (!growColumn((void **)&agents->world, sizeof(uint32_t), capacity) ||
+        !growColumn((void **)&agents->x, sizeof(uint8_t), capacity) ||
+        !growColumn((void **)&agents->y, sizeof(uint8_t), capacity) ||
+        !growColumn((void **)&agents->dir, sizeof(uint8_t), capacity) ||
+        !growColumn((void **)&agents->health, sizeof(unsigned int), capacity) ||
+        !growColumn((void **)&agents->lastHealth, sizeof(unsigned int), capacity) ||
+        !growColumn((void **)&agents->timeAlive, sizeof(size_t), capacity) ||
+        !growColumn((void **)&agents->fitness, sizeof(double), capacity) ||
+        !growColumn((void **)&agents->nn, sizeof(NN_t *), capacity) ||
+        !growColumn((void **)&agents->policy, sizeof(NNQ8_t *), capacity) ||
+        !growColumn((void **)&agents->rng, sizeof(Rng), capacity) ||
+        !growColumn((void **)&agents->vision, sizeof(double) * VISION_INPUTS, capacity) ||
+        !growColumn((void **)&agents->acted, sizeof(uint8_t), capacity)) {
+        fprintf(stderr, "Failed to grow agent storage\n");
+        return 0;
+    }
+    agents->capacity = capacity;
+    return 1;
+}
+
+int reserveFoods(Foods *foods, size_t capacity) {
+    if (capacity <= foods->capacity) return 1;
+    if (!growColumn((void **)&foods->world, sizeof(uint32_t), capacity) ||
+        !growColumn((void **)&foods->x, sizeof(uint8_t), capacity) ||
+        !growColumn((void **)&foods->y, sizeof(uint8_t), capacity)) {
+        fprintf(stderr, "Failed to grow food storage\n");
+        return 0;
+    }
+    foods->capacity = capacity;
+    return 1;
+}
+
+/* Hands every network its own buffers back. */
+void releaseBrains(Agents *agents) {
+    NNPopulation_destroy(agents->brains);
+    agents->brains = NULL;
+}
+
+int bindBrains(Agents *agents) {
+    if (agents->brains || agents->count == 0) return 1;
+    agents->brains = NNPopulation_create(agents->nn, (unsigned int)agents->count);
+    if (!agents->brains) {
+        fprintf(stderr, "Failed to create agent population\n");
+        return 0;
     }
-    
-    return one_hot_encoded;
+    return 1;
 }
 
-void destroyAgent(Agent *agent) {
-    NN_destroy(agent->nn);
-    deleteEntity(agent->entity);
-    free(agent);
+NN_t *createBrain(void) {
+    ActivationFunction hidden_activations[BRAIN_HIDDEN];
+    ActivationFunction hidden_derivatives[BRAIN_HIDDEN];
+    for (size_t i = 0; i < BRAIN_HIDDEN; i++) {
+        hidden_activations[i] = sigmoid;
+        hidden_derivatives[i] = sigmoid_derivative;
+    }
+    ActivationFunction output_activations[NUM_DIRECTIONS];
+    ActivationFunction output_derivatives[NUM_DIRECTIONS];
+    for (size_t i = 0; i < NUM_DIRECTIONS; i++) {
+        output_activations[i] = linear;
+        output_derivatives[i] = linear_derivative;
+    }
+
+    NN_t *nn = NN_create(VISION_INPUTS, BRAIN_HIDDEN, NUM_DIRECTIONS, hidden_activations, hidden_derivatives, output_activations, output_derivatives, BRAIN_LEARNING_RATE, BRAIN_MOMENTUM);
+    if (nn) {
+        NN_set_loss(nn, NN_LOSS_SOFTMAX_CROSS_ENTROPY);
+    }
+    return nn;
 }
 
-void destroyFood(Food *food) {
-    deleteEntity(food->entity);
-    free(food);
+/* Returns 1 on success; the new agent is agents->count - 1. */
+int spawnAgent(Agents *agents, Canvas *canvas, uint32_t world) {
+    if (agents->count == agents->capacity && !reserveAgents(agents, agents->capacity ? agents->capacity * 2 : 16)) {
+        return 0;
+    }
+
+    NN_t *nn = createBrain();
+    if (!nn) {
+        fprintf(stderr, "Failed to create neural network for agent\n");
+        return 0;
+    }
+    NNQ8_t *policy = NULL;
+    if (QUANTIZED_POLICY) {
+        policy = NNQ8_quantize(nn);
+        if (!policy) {
+            fprintf(stderr, "Failed to quantize neural network for agent\n");
+            NN_destroy(nn);
+            return 0;
+        }
+    }
+
+    if (agents->brains && NNPopulation_add(agents->brains, nn) != 0) {
+        NNQ8_destroy(policy);
+        NN_destroy(nn);
+        return 0;
+    }
+
+    size_t i = agents->count++;
+    Rng *rng = rngThread();
+    rngSeed(&agents->rng[i], rngNext(rng), 0);
+    agents->world[i] = world;
+    agents->x[i] = (uint8_t)rngBelow(rng, canvas->numCols);
+    agents->y[i] = (uint8_t)rngBelow(rng, canvas->numRows);
+    agents->dir[i] = (uint8_t)Directions[rngBelow(&agents->rng[i], NUM_DIRECTIONS)];
+    agents->health[i] = (unsigned int)params.initialHealth;
+    agents->lastHealth[i] = (unsigned int)params.initialHealth;
+    agents->timeAlive[i] = 0;
+    agents->fitness[i] = 0;
+    agents->nn[i] = nn;
+    agents->policy[i] = policy;
+    agents->acted[i] = 0;
+    return 1;
+}
+
+void despawnAgent(Agents *agents, size_t i) {
+    if (agents->brains) {
+        NNPopulation_remove(agents->brains, (unsigned int)i);
+    }
+    NN_destroy(agents->nn[i]);
+    NNQ8_destroy(agents->policy[i]);
+
+    size_t last = --agents->count;
+    agents->world[i] = agents->world[last];
+    agents->x[i] = agents->x[last];
+    agents->y[i] = agents->y[last];
+    agents->dir[i] = agents->dir[last];
+    agents->health[i] = agents->health[last];
+    agents->lastHealth[i] = agents->lastHealth[last];
+    agents->timeAlive[i] = agents->timeAlive[last];
+    agents->fitness[i] = agents->fitness[last];
+    agents->nn[i] = agents->nn[last];
+    agents->policy[i] = agents->policy[last];
+    agents->rng[i] = agents->rng[last];
+    agents->acted[i] = agents->acted[last];
+    memcpy(agents->vision + i * VISION_INPUTS, agents->vision + last * VISION_INPUTS, sizeof(double) * VISION_INPUTS);
 }
 
-void updateAgent(Agent *agent, Canvas *canvas, Simulation *simulation) {
-    size_t inputSize = canvas->numRows * canvas->numCols;
-    double *inputs = malloc(sizeof(double) * inputSize);
-    inputs = one_hot_encode(simulation, canvas);
+/* Starts agent i's next episode where spawnAgent would; its world and network carry over. */
+void resetAgent(Agents *agents, size_t i, const Canvas *canvas) {
+    Rng *rng = rngThread();
+    agents->x[i] = (uint8_t)rngBelow(rng, canvas->numCols);
+    agents->y[i] = (uint8_t)rngBelow(rng, canvas->numRows);
+    agents->dir[i] = (uint8_t)Directions[rngBelow(&agents->rng[i], NUM_DIRECTIONS)];
+    agents->health[i] = (unsigned int)params.initialHealth;
+    agents->lastHealth[i] = (unsigned int)params.initialHealth;
+    agents->timeAlive[i] = 0;
+    agents->fitness[i] = 0;
+    agents->acted[i] = 0;
+    NN_set_optimizer(agents->nn[i], agents->nn[i]->optimizer.kind);
+}
 
-    forward(agent->nn, inputs);
-    if (agent->nn->output[0] != 0.25 && agent->nn->output[0] != 0.75 && agent->nn->output[0] != 1.0) {
-        agent->dir = Directions[rand() % NUM_DIRECTIONS];
+void clearAgents(Agents *agents) {
+    while (agents->count > 0) {
+        despawnAgent(agents, agents->count - 1);
     }
+}
+
+void freeAgents(Agents *agents) {
+    clearAgents(agents);
+    releaseBrains(agents);
+    free(agents->world);
+    free(agents->x);
+    free(agents->y);
+    free(agents->dir);
+    free(agents->health);
+    free(agents->lastHealth);
+    free(agents->timeAlive);
+    free(agents->fitness);
+    free(agents->nn);
+    free(agents->policy);
+    free(agents->rng);
+    free(agents->vision);
+    free(agents->acted);
+}
 
-    if (agent->nn->output[0] == 0.25) {
-        agent->dir = UP;
-    } else if (agent->nn->output[0] == 0.25) {
-        agent->dir = DOWN;
-    } else if (agent->nn->output[0] == 0.75) {
-        agent->dir = LEFT;  
-    } else if (agent->nn->output[0] == 1.0) {
-        agent->dir = RIGHT;
+/* Returns 1 if food was placed, 0 if the drawn cell already has food, -1 on failure. */
+int spawnFood(Foods *foods, const Canvas *canvas, uint32_t world) {
+    if (foods->count == foods->capacity && !reserveFoods(foods, foods->capacity ? foods->capacity * 2 : 16)) {
+        return -1;
     }
+    Rng *rng = rngThread();
+    uint8_t x = (uint8_t)rngBelow(rng, canvas->numCols);
+    uint8_t y = (uint8_t)rngBelow(rng, canvas->numRows);
+    size_t cell = cellOf(canvas, world, x, y);
+    if (foods->cells[cell] != FOOD_NONE) {
+        return 0;
+    }
+
+    size_t i = foods->count++;
+    foods->world[i] = world;
+    foods->x[i] = x;
+    foods->y[i] = y;
+    foods->cells[cell] = (uint32_t)i;
+    return 1;
+}
+
+void eatFood(Foods *foods, const Canvas *canvas, size_t i) {
+    foods->cells[cellOf(canvas, foods->world[i], foods->x[i], foods->y[i])] = FOOD_NONE;
+    size_t last = --foods->count;
+    if (i == last) return;
+    foods->world[i] = foods->world[last];
+    foods->x[i] = foods->x[last];
+    foods->y[i] = foods->y[last];
+    foods->cells[cellOf(canvas, foods->world[i], foods->x[i], foods->y[i])] = (uint32_t)i;
+}
+
+void clearFoods(Foods *foods, const Canvas *canvas) {
+    for (size_t i = 0; i < foods->count; i++) {
+        foods->cells[cellOf(canvas, foods->world[i], foods->x[i], foods->y[i])] = FOOD_NONE;
+    }
+    foods->count = 0;
+}
+
+void freeFoods(Foods *foods) {
+    free(foods->world);
+    free(foods->x);
+    free(foods->y);
+    free(foods->cells);
+}
+
+/* Picks and takes the agent's move; reads nothing shared but the frozen vision. */
+Direction chooseDirection(Agents *agents, size_t a) {
+    const double *vision = agents->vision + a * VISION_INPUTS;
+    if (agents->learner) {
+        if (rngUniform(&agents->rng[a]) < params.learnerEpsilon) {
+            return Directions[rngBelow(&agents->rng[a], NUM_DIRECTIONS)];
+        }
+        double hidden[BRAIN_HIDDEN];
+        double output[NUM_DIRECTIONS];
+        NNLearner_infer(agents->learner, agents->learnerParams, vision, hidden, output);
+        return Directions[NN_argmax(output, NUM_DIRECTIONS)];
+    }
+    if (agents->policy[a]) {
+        forwardQ8(agents->policy[a], vision);
+        return Directions[NN_argmax(agents->policy[a]->output, NUM_DIRECTIONS)];
+    }
+    return Directions[NN_argmax(agents->nn[a]->output, NUM_DIRECTIONS)];
+}
 
-    if (agent->dir == UP) {
-        agent->entity->cell.pos.y--;
-    } else if (agent->dir == DOWN) {
-        agent->entity->cell.pos.y++;
-    } else if (agent->dir == LEFT) {
-        agent->entity->cell.pos.x--;
-    } else if (agent->dir == RIGHT) {
-        agent->entity->cell.pos.x++;
+void moveAgent(Agents *agents, size_t a, const Canvas *canvas, Direction dir) {
+    agents->dir[a] = (uint8_t)dir;
+    agents->lastHealth[a] = agents->health[a];
+
+    if (dir == UP) {
+        agents->y[a]--;
+    } else if (dir == DOWN) {
+        agents->y[a]++;
+    } else if (dir == LEFT) {
+        agents->x[a]--;
+    } else if (dir == RIGHT) {
+        agents->x[a]++;
     }
      
-    if (agent->entity->cell.pos.x < 1) {
-        agent->entity->cell.pos.x = canvas->numCols - 2;
-    } else if (agent->entity->cell.pos.x >= canvas->numCols) {
-        agent->entity->cell.pos.x = 1;
+    if (agents->x[a] < 1) {
+        agents->x[a] = canvas->numCols - 2;
+    } else if (agents->x[a] >= canvas->numCols) {
+        agents->x[a] = 1;
     }
   
-    if (agent->entity->cell.pos.y < 1) {
-        agent->entity->cell.pos.y = canvas->numRows - 2;
-    } else if (agent->entity->cell.pos.y >= canvas->numRows) {
-        agent->entity->cell.pos.y = 1;
+    if (agents->y[a] < 1) {
+        agents->y[a] = canvas->numRows - 2;
+    } else if (agents->y[a] >= canvas->numRows) {
+        agents->y[a] = 1;
     }
 
-    agent->entity->health -= HEALTH_DECAY_RATE;
-    agent->time_alive++;
+    agents->health[a] = drain(agents->health[a], (unsigned int)params.healthDecayRate);
+    agents->timeAlive[a]++;
+}
 
-    if (agent->is_predator) {
-        for (size_t i = 0; i < simulation->numPreys; i++) {
-            double dist = distance(agent->entity->cell.pos, simulation->preys[i]->entity->cell.pos);
-            if (dist < CATCH_DISTANCE) {
-                agent->entity->health += PREDATOR_GAIN;
-                simulation->preys[i]->entity->health -= PREDATOR_GAIN;
-            }
-        }
+/*
+ * Agents of others in world within the catch radius of (x, y). Positions wrap
+ * over 1..numCols - 1 and 1..numRows - 1, as moveAgent wraps them.
+ */
+static size_t encounters(const Agents *others, const Canvas *canvas, uint32_t world, uint8_t x, uint8_t y) {
+    uint64_t mask[PROXIMITY_WORDS(PROXIMITY_BLOCK)];
+    int radius = (int)params.catchRadius;
+    size_t found = 0;
+    for (size_t base = 0; base < others->count; base += PROXIMITY_BLOCK) {
+        size_t n = others->count - base < PROXIMITY_BLOCK ? others->count - base : PROXIMITY_BLOCK;
+        found += proximityMask(x, y, others->x + base, others->y + base, others->world + base, world, n,
+                               canvas->numCols - 1, canvas->numRows - 1, radius * radius, mask);
+    }
+    return found;
+}
+
+/*
+ * Every predator gains the predator gain per prey within the catch radius
+ * and every prey loses it per predator, so the outcome does not depend on update
+ * order. The agent then trains on the sign of its change in health.
+ */
+void learnAgent(Agents *agents, size_t a, const Canvas *canvas, const Simulation *simulation) {
+    size_t cell = cellOf(canvas, agents->world[a], agents->x[a], agents->y[a]);
+    const Agents *others = agents->isPredator ? &simulation->preys : &simulation->predators;
+    size_t caught = (int)params.catchRadius > 0 ? encounters(others, canvas, agents->world[a], agents->x[a], agents->y[a])
+                  : agents->isPredator ? simulation->preyCount[cell] : simulation->predatorCount[cell];
+    if (agents->isPredator) {
+        agents->health[a] += (unsigned int)params.predatorGain * caught;
     } else {
-        for (size_t i = 0; i < simulation->numFoods; i++) {
-            double dist = distance(agent->entity->cell.pos, simulation->foods[i]->entity->cell.pos);
-            if (dist < CATCH_DISTANCE) {
-                agent->entity->health += PREY_GAIN;
-                destroyFood(simulation->foods[i]);
-                simulation->foods[i] = simulation->foods[--simulation->numFoods];
-                break;
+        agents->health[a] = drain(agents->health[a], (unsigned int)params.predatorGain * caught);
+    }
+
+    agents->fitness[a] = agents->isPredator ? calculatePredatorFitness(agents, a) : calculatePreyFitness(agents, a);
+    if (agents->policy[a] || agents->learner) {
+        return;
+    }
+
+    double reward = (double)agents->health[a] - (double)agents->lastHealth[a];
+    if (reward != 0) {
+        double target[NUM_DIRECTIONS] = {0};
+        target[agents->dir[a]] = reward > 0 ? 1 : -1;
+        backprop(agents->nn[a], target);
+    }
+}
+
+/*
+ * Observes the agent's new surroundings and hands the step that led there
+ * (previous vision, move and change in health) to the species' learner.
+ */
+static void replayStep(Agents *agents, size_t a, const uint8_t *occupancy, const Canvas *canvas) {
+    double next[VISION_INPUTS];
+    double *vision = agents->vision + a * VISION_INPUTS;
+    observe(occupancy, canvas, agents->x[a], agents->y[a], next);
+    if (agents->acted[a]) {
+        double scale = params.predatorGain > 0 ? params.predatorGain : 1;
+        double reward = ((double)agents->health[a] - (double)agents->lastHealth[a]) / scale;
+        NNLearner_push(agents->learner, vision, agents->dir[a], reward, next, agents->health[a] == 0);
+    }
+    memcpy(vision, next, sizeof(double) * VISION_INPUTS);
+    agents->acted[a] = 1;
+}
+
+/* Clips the worker's slice of the combined predator-then-prey index space to one species. */
+static int speciesRange(const SimulationWorker *worker, size_t offset, size_t count, size_t *begin, size_t *end) {
+    *begin = worker->begin > offset ? worker->begin - offset : 0;
+    *end = worker->end > offset ? worker->end - offset : 0;
+    if (*end > count) *end = count;
+    return *begin < *end;
+}
+
+static void decideRange(void *arg) {
+    SimulationWorker *worker = (SimulationWorker *)arg;
+    Simulation *simulation = worker->simulation;
+    const Canvas *canvas = worker->canvas;
+    Agents *species[2] = {&simulation->predators, &simulation->preys};
+    size_t offset = 0;
+    for (int s = 0; s < 2; offset += species[s]->count, s++) {
+        Agents *agents = species[s];
+        size_t begin, end;
+        if (!speciesRange(worker, offset, agents->count, &begin, &end)) continue;
+        for (size_t i = begin; i < end; i++) {
+            const uint8_t *occupancy = simulation->occupancy + cellOf(canvas, agents->world[i], 0, 0);
+            double *vision = agents->vision + i * VISION_INPUTS;
+            if (agents->learner) {
+                replayStep(agents, i, occupancy, canvas);
+            } else {
+                observe(occupancy, canvas, agents->x[i], agents->y[i], vision);
             }
         }
+        if (agents->brains && !agents->learner && !QUANTIZED_POLICY) {
+            NNPopulation_forward_range(agents->brains, (unsigned int)begin, (unsigned int)(end - begin), agents->vision, VISION_INPUTS);
+        }
+        for (size_t i = begin; i < end; i++) {
+            moveAgent(agents, i, canvas, chooseDirection(agents, i));
+        }
     }
+}
 
-    if (agent->entity->cell.c == 'X') {
-        agent->fitness = calculatePredatorFitness(agent);
-        backprop(agent->nn, &agent->fitness);
-    } else if (agent->entity->cell.c == 'O') {
-        agent->fitness = calculatePreyFitness(agent);
-        backprop(agent->nn, &agent->fitness);
+static void learnRange(void *arg) {
+    SimulationWorker *worker = (SimulationWorker *)arg;
+    Simulation *simulation = worker->simulation;
+    Agents *species[2] = {&simulation->predators, &simulation->preys};
+    size_t offset = 0;
+    for (int s = 0; s < 2; offset += species[s]->count, s++) {
+        size_t begin, end;
+        if (!speciesRange(worker, offset, species[s]->count, &begin, &end)) continue;
+        for (size_t i = begin; i < end; i++) {
+            learnAgent(species[s], i, worker->canvas, simulation);
+        }
     }
+}
 
-    free(inputs);
+static void runPhase(Simulation *simulation, const Canvas *canvas, void (*phase)(void *)) {
+    size_t total = simulation->predators.count + simulation->preys.count;
+    unsigned int numWorkers = simulation->numWorkers;
+    for (unsigned int w = 0; w < numWorkers; w++) {
+        SimulationWorker *worker = &simulation->workers[w];
+        worker->simulation = simulation;
+        worker->canvas = canvas;
+        worker->begin = total * w / numWorkers;
+        worker->end = total * (w + 1) / numWorkers;
+        if (!simulation->pool || !threadPoolAddTask(simulation->pool, phase, worker)) {
+            phase(worker);
+        }
+    }
+    if (simulation->pool) {
+        threadPoolWait(simulation->pool);
+    }
 }
 
-Agent *createAgent(Canvas *canvas, const char *type, char symbol, size_t is_predator) {
-    Agent *agent = malloc(sizeof(Agent)); 
-    if (!agent) {
-        fprintf(stderr, "Failed to allocate memory for agent\n");
-        return NULL;
+/*
+ * Counts agents per cell on the moved positions and hands the food on a
+ * cell to the lowest-indexed prey standing there.
+ */
+void resolveMoves(Simulation *simulation, const Canvas *canvas) {
+    Agents *predators = &simulation->predators;
+    Agents *preys = &simulation->preys;
+    for (size_t i = 0; i < predators->count; i++) {
+        simulation->predatorCount[cellOf(canvas, predators->world[i], predators->x[i], predators->y[i])]++;
+    }
+    for (size_t i = preys->count; i-- > 0;) {
+        size_t cell = cellOf(canvas, preys->world[i], preys->x[i], preys->y[i]);
+        simulation->preyCount[cell]++;
+        simulation->firstPrey[cell] = (uint32_t)i;
     }
 
-    Color color = is_predator ? (Color){255,0,0} : (Color){0,255,0};
-    Entity *entity = createEntity((TYPE){type}, symbol, rand() % canvas->numCols, rand() % canvas->numRows, 1, color, NULL);
-    if (!entity) {
-        fprintf(stderr, "Failed to create entity for agent\n");
-        destroyAgent(agent); 
-        return NULL;
+    Foods *foods = &simulation->foods;
+    for (size_t i = 0; i < preys->count; i++) {
+        size_t cell = cellOf(canvas, preys->world[i], preys->x[i], preys->y[i]);
+        simulation->catches += (int)params.catchRadius > 0 ? encounters(predators, canvas, preys->world[i], preys->x[i], preys->y[i])
+                                                : simulation->predatorCount[cell];
+        uint32_t food = foods->cells[cell];
+        if (food == FOOD_NONE || simulation->firstPrey[cell] != i) continue;
+        preys->health[i] += (unsigned int)params.preyGain;
+        simulation->worldFoods[preys->world[i]]--;
+        simulation->foodEaten++;
+        eatFood(foods, canvas, food);
     }
-    addEntity(canvas, entity);
-
-    agent->entity = entity;
-    agent->dir = Directions[rand() % NUM_DIRECTIONS];
-    agent->fitness = 0;
-    agent->is_predator = is_predator;
-    agent->entity->health = INITIAL_HEALTH;
-    agent->time_alive = 0;
-    agent->nn = NULL;
-    ActivationFunction hidden_activations[20];
-    ActivationFunction hidden_derivatives[20];
-    for (size_t i = 0; i < 20; i++) {
-        hidden_activations[i] = sigmoid;
-        hidden_derivatives[i] = sigmoid_derivative;
+}
+
+void clearResolution(Simulation *simulation, const Canvas *canvas) {
+    Agents *predators = &simulation->predators;
+    Agents *preys = &simulation->preys;
+    for (size_t i = 0; i < predators->count; i++) {
+        simulation->predatorCount[cellOf(canvas, predators->world[i], predators->x[i], predators->y[i])] = 0;
+    }
+    for (size_t i = 0; i < preys->count; i++) {
+        size_t cell = cellOf(canvas, preys->world[i], preys->x[i], preys->y[i]);
+        simulation->preyCount[cell] = 0;
+        simulation->firstPrey[cell] = UINT32_MAX;
     }
-    ActivationFunction output_activations = tanh;
-    ActivationFunction output_derivatives = tanh_derivative;
+}
 
-    agent->nn = NN_create(10, 20, 1, hidden_activations, hidden_derivatives, &output_activations, &output_derivatives, 1, 1);
-    if (!agent->nn) {
-        fprintf(stderr, "Failed to create neural network for agent\n");
-        destroyAgent(agent);
-        return NULL;
+size_t anyAlive(const Agents *agents) {
+    for (size_t i = 0; i < agents->count; i++) {
+        if (agents->health[i] > 0) return 1;
     }
+    return 0;
+}
+
+size_t checkAliveEntities(Simulation *simulation) {
+    return anyAlive(&simulation->predators) || anyAlive(&simulation->preys);
+}
 
-    return agent;
+/* A generation ends when every agent has died or after episode_ticks, which also bounds runs where nothing dies. */
+int generationOver(Simulation *simulation) {
+    return !checkAliveEntities(simulation) || simulation->tick - simulation->generationStart >= (size_t)params.episodeTicks;
 }
 
-Food *createFood(Canvas *canvas) {
-    Food *food = malloc(sizeof(Food));
-    if (!food) {
-        fprintf(stderr, "Failed to allocate memory for food\n");
-        return NULL;
+static EvolutionConfig breeding;
+
+/* Refreshes breeding from params; call from the thread that breeds, before breeding starts. */
+static const EvolutionConfig *breedingConfig(void) {
+    breeding = (EvolutionConfig){
+        .selection = EVOLUTION_TOURNAMENT,
+        .tournamentSize = (unsigned int)params.tournamentSize,
+        .elites = (size_t)params.elites,
+        .crossoverRate = params.crossoverRate,
+        .mutationRate = params.mutationRate,
+        .mutationStddev = params.mutationStddev,
+    };
+    return &breeding;
+}
+
+void evolveBrains(Evolution *evolution, Agents *agents) {
+    if (agents->count == 0 || !bindBrains(agents)) return;
+    NNPopulation *brains = agents->brains;
+    if (evolutionBreed(evolution, breedingConfig(), brains->params, brains->nextParams, brains->paramStride,
+                       agents->nn[0]->numParams, agents->fitness, agents->count, rngNext(rngThread())) != 0) {
+        return;
     }
+    NNPopulation_swap(brains);
 
-    Entity *entity = createEntity((TYPE){"FOOD"}, '*', rand() % canvas->numCols, rand() % canvas->numRows, 1, (Color){0,255,255}, NULL);
-    if (!entity) {
-        fprintf(stderr, "Failed to create entity for food\n");
-        free(food);
-        return NULL;
+    for (size_t i = 0; i < agents->count; i++) {
+        if (agents->policy[i]) {
+            NNQ8_requantize(agents->policy[i], agents->nn[i]);
+        }
     }
-    addEntity(canvas, entity);
+}
 
-    food->entity = entity;
-    return food;
+void evolvePopulation(Simulation *simulation) {
+    evolveBrains(simulation->evolution, &simulation->predators);
+    evolveBrains(simulation->evolution, &simulation->preys);
 }
 
-size_t checkAliveEntities(Simulation *simulation) {
-    for (size_t i = 0; i < simulation->numPredators; i++) {
-        if (simulation->predators[i]->entity->health > 0) return 1;
+/*
+ * Sends the MIGRANTS fittest genomes to the next island and lets arrivals
+ * replace the weakest, keeping the fitness they earned at home so they
+ * compete in the breeding that follows.
+ */
+void migrate(Island *island, Agents *agents) {
+    size_t picked[MIGRANTS];
+    size_t numPicked = 0;
+    for (size_t m = 0; m < MIGRANTS && m < agents->count; m++) {
+        size_t best = SIZE_MAX;
+        for (size_t i = 0; i < agents->count; i++) {
+            int taken = 0;
+            for (size_t j = 0; j < numPicked; j++) taken |= picked[j] == i;
+            if (!taken && (best == SIZE_MAX || agents->fitness[i] > agents->fitness[best])) best = i;
+        }
+        picked[numPicked++] = best;
+        islandEmigrate(island, agents->nn[best]->params, agents->fitness[best]);
+    }
+
+    numPicked = 0;
+    for (size_t m = 0; m < MIGRANTS && m < agents->count; m++) {
+        size_t worst = SIZE_MAX;
+        for (size_t i = 0; i < agents->count; i++) {
+            int taken = 0;
+            for (size_t j = 0; j < numPicked; j++) taken |= picked[j] == i;
+            if (!taken && (worst == SIZE_MAX || agents->fitness[i] < agents->fitness[worst])) worst = i;
+        }
+        if (!islandImmigrate(island, agents->nn[worst]->params, &agents->fitness[worst])) break;
+        if (agents->policy[worst]) {
+            NNQ8_requantize(agents->policy[worst], agents->nn[worst]);
+        }
+        picked[numPicked++] = worst;
     }
-    for (size_t i = 0; i < simulation->numPreys; i++) {
-        if (simulation->preys[i]->entity->health > 0) return 1;
+}
+
+int attachIslands(Simulation *simulation, const IslandOptions *options) {
+    if (options->count < 2) return 1;
+    simulation->predatorIsland = islandCreate(options->dir, "predprey-predator", options->id, options->count, simulation->predators.nn[0]->numParams);
+    simulation->preyIsland = islandCreate(options->dir, "predprey-prey", options->id, options->count, simulation->preys.nn[0]->numParams);
+    return simulation->predatorIsland && simulation->preyIsland;
+}
+
+static const NNLearnerConfig learning = {
+    .capacity = 1 << 16,
+    .queueCapacity = 1 << 13,
+    .batchSize = 32,
+    .trainEvery = 4,
+    .publishEvery = 8,
+    .gamma = 0.95,
+};
+
+int attachLearner(Agents *agents, uint64_t seed) {
+    NN_t *nn = createBrain();
+    if (!nn) return 0;
+    nn->learningRate = params.learnerRate;
+    NN_set_optimizer(nn, NN_ADAM);
+    agents->learner = NNLearner_create(nn, &learning, seed);
+    if (!agents->learner) {
+        NN_destroy(nn);
+        return 0;
     }
-    return 0;
+    memset(agents->acted, 0, agents->count);
+    return NNLearner_start(agents->learner) == 0;
 }
 
-void mutate(NN_t *nn) {
-    for (size_t i = 0; i < nn->numWeights; i++) {
-        if ((double)rand() / RAND_MAX < MUTATION_RATE) {
-            nn->weights[i] += ((double)rand() / RAND_MAX - 0.5) * 0.1;
-        }
+/* Replaces per-agent inline backprop with one off-thread learner per species. */
+int attachLearners(Simulation *simulation) {
+    Rng *rng = rngThread();
+    return attachLearner(&simulation->predators, rngNext(rng)) && attachLearner(&simulation->preys, rngNext(rng));
+}
+
+static double monotonicSeconds(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+static void summarizeFitness(const Agents *agents, double *best, double *mean) {
+    double total = 0;
+    *best = 0;
+    for (size_t i = 0; i < agents->count; i++) {
+        total += agents->fitness[i];
+        if (i == 0 || agents->fitness[i] > *best) *best = agents->fitness[i];
     }
+    *mean = agents->count ? total / (double)agents->count : 0;
 }
 
+/* Records the ticks since the last record; a no-op without a telemetry sink. */
+void reportTelemetry(Simulation *simulation) {
+    if (!simulation->telemetry) return;
+    double now = monotonicSeconds();
+    double elapsed = now - simulation->reportTime;
+    TelemetryRecord record = {
+        .tick = simulation->tick,
+        .source = simulation->telemetrySource,
+        .generation = (uint32_t)simulation->generation,
+        .predators = (uint32_t)simulation->predators.count,
+        .preys = (uint32_t)simulation->preys.count,
+        .catches = (uint32_t)simulation->catches,
+        .foodEaten = (uint32_t)simulation->foodEaten,
+        .ticksPerSecond = elapsed > 0 ? (double)(simulation->tick - simulation->reportTick) / elapsed : 0,
+    };
+    summarizeFitness(&simulation->predators, &record.predatorBest, &record.predatorMean);
+    summarizeFitness(&simulation->preys, &record.preyBest, &record.preyMean);
+    telemetryRecord(simulation->telemetry, simulation->telemetryProducer, &record);
 
-void crossover(NN_t *parent1, NN_t *parent2, NN_t *child) {
-    for (size_t i = 0; i < parent1->numWeights; i++) {
-        if ((double)rand() / RAND_MAX < CROSSOVER_RATE) {
-            child->weights[i] = parent1->weights[i];
-        } else {
-            child->weights[i] = parent2->weights[i];
+    simulation->catches = 0;
+    simulation->foodEaten = 0;
+    simulation->reportTick = simulation->tick;
+    simulation->reportTime = now;
+}
+
+/* producer must be the only thread stepping this simulation among the sink's producers. */
+void attachTelemetry(Simulation *simulation, Telemetry *telemetry, unsigned int source, unsigned int producer) {
+    simulation->telemetry = telemetry;
+    simulation->telemetrySource = source;
+    simulation->telemetryProducer = producer;
+    simulation->reportTick = simulation->tick;
+    simulation->reportTime = monotonicSeconds();
+}
+
+/* Islands other than 0 use PATH.ID so every process owns its files. */
+static void islandPath(char *name, size_t size, const char *path, unsigned int island) {
+    if (island > 0) {
+        snprintf(name, size, "%s.%u", path, island);
+    } else {
+        snprintf(name, size, "%s", path);
+    }
+}
+
+/* A .bin path selects the binary format. */
+Telemetry *openTelemetry(const char *path, unsigned int island, unsigned int numProducers) {
+    if (!path) return NULL;
+    char name[4096];
+    islandPath(name, sizeof(name), path, island);
+    size_t length = strlen(path);
+    TelemetryFormat format = length >= 4 && strcmp(path + length - 4, ".bin") == 0 ? TELEMETRY_BINARY : TELEMETRY_CSV;
+    return telemetryOpen(name, format, numProducers, TELEMETRY_CAPACITY);
+}
+
+static void putAgents(CheckpointBuffer *buffer, const Agents *agents) {
+    uint64_t count = agents->count;
+    size_t n = agents->count;
+    checkpointPut(buffer, &count, sizeof(count));
+    checkpointPut(buffer, agents->world, sizeof(uint32_t) * n);
+    checkpointPut(buffer, agents->x, n);
+    checkpointPut(buffer, agents->y, n);
+    checkpointPut(buffer, agents->dir, n);
+    checkpointPut(buffer, agents->health, sizeof(unsigned int) * n);
+    checkpointPut(buffer, agents->lastHealth, sizeof(unsigned int) * n);
+    checkpointPut(buffer, agents->timeAlive, sizeof(size_t) * n);
+    checkpointPut(buffer, agents->fitness, sizeof(double) * n);
+    checkpointPut(buffer, agents->rng, sizeof(Rng) * n);
+    checkpointPut(buffer, agents->acted, n);
+    checkpointPut(buffer, agents->vision, sizeof(double) * VISION_INPUTS * n);
+    for (size_t i = 0; i < n; i++) {
+        NN_t *nn = agents->nn[i];
+        uint64_t step = nn->optimizer.step;
+        checkpointPut(buffer, nn->params, sizeof(double) * nn->numParams);
+        checkpointPut(buffer, nn->weightsO, sizeof(double) * nn->numParams);
+        checkpointPut(buffer, nn->gradientO, sizeof(double) * nn->numParams);
+        checkpointPut(buffer, &step, sizeof(step));
+    }
+}
+
+static int getAgents(CheckpointReader *reader, Agents *agents, Canvas *canvas, size_t numWorlds) {
+    uint64_t count;
+    if (!checkpointGet(reader, &count, sizeof(count)) || count > reader->size - reader->offset) return 0;
+    clearAgents(agents);
+    for (size_t i = 0; i < count; i++) {
+        if (!spawnAgent(agents, canvas, 0)) return 0;
+    }
+
+    size_t n = agents->count;
+    checkpointGet(reader, agents->world, sizeof(uint32_t) * n);
+    checkpointGet(reader, agents->x, n);
+    checkpointGet(reader, agents->y, n);
+    checkpointGet(reader, agents->dir, n);
+    checkpointGet(reader, agents->health, sizeof(unsigned int) * n);
+    checkpointGet(reader, agents->lastHealth, sizeof(unsigned int) * n);
+    checkpointGet(reader, agents->timeAlive, sizeof(size_t) * n);
+    checkpointGet(reader, agents->fitness, sizeof(double) * n);
+    checkpointGet(reader, agents->rng, sizeof(Rng) * n);
+    checkpointGet(reader, agents->acted, n);
+    checkpointGet(reader, agents->vision, sizeof(double) * VISION_INPUTS * n);
+    for (size_t i = 0; i < n; i++) {
+        NN_t *nn = agents->nn[i];
+        uint64_t step = 0;
+        checkpointGet(reader, nn->params, sizeof(double) * nn->numParams);
+        checkpointGet(reader, nn->weightsO, sizeof(double) * nn->numParams);
+        checkpointGet(reader, nn->gradientO, sizeof(double) * nn->numParams);
+        checkpointGet(reader, &step, sizeof(step));
+        nn->optimizer.step = step;
+        if (agents->world[i] >= numWorlds || agents->x[i] >= canvas->numCols || agents->y[i] >= canvas->numRows) {
+            return 0;
+        }
+        if (agents->policy[i]) {
+            NNQ8_requantize(agents->policy[i], agents->nn[i]);
         }
     }
+    return !reader->failed;
 }
 
-int compareFitness(const void *a, const void *b) {
-    Agent *agentA = *(Agent**)a;
-    Agent *agentB = *(Agent**)b;
-    return (agentB->fitness > agentA->fitness) - (agentB->fitness < agentA->fitness);
+/*
+ * Serializes the whole batch (agents with their genomes, optimizer state
+ * and RNG streams, food, the fitness history and this thread's RNG) and
+ * hands it to the background writer. Learner state is not included.
+ */
+void checkpointSimulation(Simulation *simulation, const Canvas *canvas) {
+    if (!simulation->checkpointer) return;
+    CheckpointBuffer *buffer = &simulation->snapshot;
+    uint32_t shape[2] = {canvas->numRows, canvas->numCols};
+    uint64_t counters[5] = {simulation->numWorlds, simulation->tick, simulation->generation,
+                            simulation->generationStart, simulation->historyCount};
+    checkpointPut(buffer, shape, sizeof(shape));
+    checkpointPut(buffer, counters, sizeof(counters));
+    checkpointPut(buffer, rngThread(), sizeof(Rng));
+    checkpointPut(buffer, simulation->history, sizeof(GenerationStats) * simulation->historyCount);
+    putAgents(buffer, &simulation->predators);
+    putAgents(buffer, &simulation->preys);
+
+    Foods *foods = &simulation->foods;
+    uint64_t numFoods = foods->count;
+    checkpointPut(buffer, &numFoods, sizeof(numFoods));
+    checkpointPut(buffer, foods->world, sizeof(uint32_t) * foods->count);
+    checkpointPut(buffer, foods->x, foods->count);
+    checkpointPut(buffer, foods->y, foods->count);
+
+    if (checkpointerSubmit(simulation->checkpointer, buffer) != 0) {
+        fprintf(stderr, "Skipped incomplete checkpoint at tick %zu\n", simulation->tick);
+    }
+}
+
+static int getFoods(CheckpointReader *reader, Simulation *simulation, Canvas *canvas) {
+    Foods *foods = &simulation->foods;
+    uint64_t numFoods;
+    clearFoods(foods, canvas);
+    if (!checkpointGet(reader, &numFoods, sizeof(numFoods)) || numFoods > reader->size - reader->offset ||
+        !reserveFoods(foods, numFoods)) {
+        return 0;
+    }
+    checkpointGet(reader, foods->world, sizeof(uint32_t) * numFoods);
+    checkpointGet(reader, foods->x, numFoods);
+    checkpointGet(reader, foods->y, numFoods);
+    if (reader->failed) return 0;
+    memset(simulation->worldFoods, 0, sizeof(size_t) * simulation->numWorlds);
+    for (size_t i = 0; i < numFoods; i++) {
+        if (foods->world[i] >= simulation->numWorlds || foods->x[i] >= canvas->numCols || foods->y[i] >= canvas->numRows) {
+            return 0;
+        }
+        size_t cell = cellOf(canvas, foods->world[i], foods->x[i], foods->y[i]);
+        if (foods->cells[cell] != FOOD_NONE) return 0;
+        foods->cells[cell] = (uint32_t)i;
+        foods->count = i + 1;
+        simulation->worldFoods[foods->world[i]]++;
+    }
+    return 1;
 }
-void evolvePopulation(Simulation *simulation) {
-    qsort(simulation->predators, simulation->numPredators, sizeof(Agent*), compareFitness);
-    qsort(simulation->preys, simulation->numPreys, sizeof(Agent*), compareFitness);
 
-    for (size_t i = MAX_PREDATORS / 2; i < MAX_PREDATORS; i++) {
-        size_t parent1 = rand() % (MAX_PREDATORS / 2);
-        size_t parent2 = rand() % (MAX_PREDATORS / 2);
-        crossover(simulation->predators[parent1]->nn, simulation->predators[parent2]->nn, simulation->predators[i]->nn);
-        mutate(simulation->predators[i]->nn);
+static int loadSimulation(Simulation *simulation, Canvas *canvas, CheckpointReader *reader) {
+    uint32_t shape[2];
+    uint64_t counters[5];
+    Rng rng;
+    if (!checkpointGet(reader, shape, sizeof(shape)) || !checkpointGet(reader, counters, sizeof(counters)) ||
+        !checkpointGet(reader, &rng, sizeof(rng))) {
+        return 0;
+    }
+    if (shape[0] != canvas->numRows || shape[1] != canvas->numCols || counters[0] != simulation->numWorlds) {
+        fprintf(stderr, "Checkpoint holds %llu worlds of %ux%u, not %zu of %ux%u\n", (unsigned long long)counters[0],
+                shape[0], shape[1], simulation->numWorlds, canvas->numRows, canvas->numCols);
+        return 0;
     }
+    if (counters[4] > (reader->size - reader->offset) / sizeof(GenerationStats)) return 0;
+    size_t historyCount = (size_t)counters[4];
+    GenerationStats *history = malloc(sizeof(GenerationStats) * (historyCount ? historyCount : 1));
+    if (!history) return 0;
+    checkpointGet(reader, history, sizeof(GenerationStats) * historyCount);
 
-    for (size_t i = MAX_PREY / 2; i < MAX_PREY; i++) {
-        size_t parent1 = rand() % (MAX_PREY / 2);
-        size_t parent2 = rand() % (MAX_PREY / 2);
-        crossover(simulation->preys[parent1]->nn, simulation->preys[parent2]->nn, simulation->preys[i]->nn);
-        mutate(simulation->preys[i]->nn);
+    if (!getAgents(reader, &simulation->predators, canvas, simulation->numWorlds) ||
+        !getAgents(reader, &simulation->preys, canvas, simulation->numWorlds) ||
+        !getFoods(reader, simulation, canvas)) {
+        free(history);
+        return 0;
     }
+
+    free(simulation->history);
+    simulation->history = history;
+    simulation->historyCapacity = historyCount ? historyCount : 1;
+    simulation->historyCount = historyCount;
+    simulation->tick = counters[1];
+    simulation->generation = counters[2];
+    simulation->generationStart = counters[3];
+    *rngThread() = rng;
+    return 1;
 }
 
 void updateSimulation(Simulation *simulation, Canvas *canvas) {
-    for (size_t i = 0; i < simulation->numPredators; i++) {
-        updateAgent(simulation->predators[i], canvas, simulation);
+    buildOccupancy(simulation, canvas);
+    if (simulation->predators.learner) {
+        simulation->predators.learnerParams = NNLearner_acquire(simulation->predators.learner);
     }
-    for (size_t i = 0; i < simulation->numPreys; i++) {
-        updateAgent(simulation->preys[i], canvas, simulation);
+    if (simulation->preys.learner) {
+        simulation->preys.learnerParams = NNLearner_acquire(simulation->preys.learner);
     }
+    if (!QUANTIZED_POLICY) {
+        bindBrains(&simulation->predators);
+        bindBrains(&simulation->preys);
+    }
+
+    runPhase(simulation, canvas, decideRange);
+    resolveMoves(simulation, canvas);
+    runPhase(simulation, canvas, learnRange);
+    clearResolution(simulation, canvas);
 
-    if ((double)rand() / RAND_MAX < FOOD_RESPAWN_RATE && simulation->numFoods < MAX_FOOD) {
-        Food *newFood = createFood(canvas);
-        if (newFood) {
-            simulation->foods[simulation->numFoods++] = newFood;
+    Rng *rng = rngThread();
+    for (uint32_t w = 0; w < simulation->numWorlds; w++) {
+        double rate = params.foodRespawnRate;
+        size_t spawns = (size_t)rate + (rngUniform(rng) < rate - (size_t)rate);
+        for (size_t k = 0; k < spawns && simulation->worldFoods[w] < (size_t)params.maxFood; k++) {
+            if (spawnFood(&simulation->foods, canvas, w) > 0) {
+                simulation->worldFoods[w]++;
+            }
         }
     }
 
-    //evolvePopulation(simulation);
+    simulation->tick++;
+    if (simulation->telemetry && simulation->tick - simulation->reportTick >= TELEMETRY_INTERVAL) {
+        reportTelemetry(simulation);
+    }
+    if (simulation->checkpointer && simulation->tick % CHECKPOINT_INTERVAL == 0) {
+        checkpointSimulation(simulation, canvas);
+    }
 }
 
 void destroySimulation(Simulation *simulation) {
-    for (size_t i = 0; i < simulation->numPredators; i++) {
-        destroyAgent(simulation->predators[i]);
+    NNLearner_destroy(simulation->predators.learner);
+    NNLearner_destroy(simulation->preys.learner);
+    evolutionDestroy(simulation->evolution);
+    islandDestroy(simulation->predatorIsland);
+    islandDestroy(simulation->preyIsland);
+    freeAgents(&simulation->predators);
+    freeAgents(&simulation->preys);
+    freeFoods(&simulation->foods);
+    if (simulation->pool) {
+        threadPoolDestroy(simulation->pool);
     }
-    for (size_t i = 0; i < simulation->numPreys; i++) {
-        destroyAgent(simulation->preys[i]);
+    free(simulation->workers);
+    free(simulation->occupancy);
+    free(simulation->predatorCount);
+    free(simulation->preyCount);
+    free(simulation->firstPrey);
+    free(simulation->worldFoods);
+    free(simulation->history);
+    checkpointBufferFree(&simulation->snapshot);
+    free(simulation);
+}
+
+int stockWorld(Simulation *simulation, Canvas *canvas, uint32_t world) {
+    simulation->worldFoods[world] = 0;
+    while (simulation->worldFoods[world] < (size_t)params.maxFood / 2) {
+        int placed = spawnFood(&simulation->foods, canvas, world);
+        if (placed < 0) {
+            fprintf(stderr, "Failed to create food\n");
+            return 0;
+        }
+        simulation->worldFoods[world] += (size_t)placed;
     }
-    for (size_t i = 0; i < simulation->numFoods; i++) {
-        destroyFood(simulation->foods[i]);
+    return 1;
+}
+
+int populateWorld(Simulation *simulation, Canvas *canvas, uint32_t world) {
+    for (size_t i = 0; i < (size_t)params.initialPredators; i++) {
+        if (!spawnAgent(&simulation->predators, canvas, world)) {
+            fprintf(stderr, "Failed to create predator\n");
+            return 0;
+        }
     }
-    free(simulation);
+    for (size_t i = 0; i < (size_t)params.initialPrey; i++) {
+        if (!spawnAgent(&simulation->preys, canvas, world)) {
+            fprintf(stderr, "Failed to create prey\n");
+            return 0;
+        }
+    }
+    return stockWorld(simulation, canvas, world);
+}
+
+int populateSimulation(Simulation *simulation, Canvas *canvas) {
+    for (uint32_t w = 0; w < simulation->numWorlds; w++) {
+        if (!populateWorld(simulation, canvas, w)) return 0;
+    }
+    return bindBrains(&simulation->predators) && bindBrains(&simulation->preys);
 }
 
-Simulation* createSimulation(Canvas *canvas) {
-    Simulation *simulation = malloc(sizeof(Simulation));
+Simulation* createSimulation(Canvas *canvas, size_t numWorlds, int numThreads) {
+    Simulation *simulation = calloc(1, sizeof(Simulation));
     if (!simulation) {
         fprintf(stderr, "Failed to allocate memory for simulation\n");
         return NULL;
     }
 
-    simulation->numPredators = MAX_PREDATORS;
-    simulation->numPreys = MAX_PREY;
-    simulation->numFoods = MAX_FOOD / 2;  
+    simulation->predators.symbol = 'X';
+    simulation->predators.color = (Color){255,0,0};
+    simulation->predators.isPredator = 1;
+    simulation->preys.symbol = 'O';
+    simulation->preys.color = (Color){0,255,0};
+    simulation->preys.isPredator = 0;
+    simulation->numWorlds = numWorlds ? numWorlds : 1;
+    simulation->evolution = evolutionCreate(simulation->numWorlds * (size_t)(params.initialPredators > params.initialPrey ? params.initialPredators : params.initialPrey), numThreads);
+    if (!simulation->evolution) {
+        fprintf(stderr, "Failed to create evolution workers\n");
+        destroySimulation(simulation);
+        return NULL;
+    }
 
-    for (size_t i = 0; i < MAX_PREDATORS; i++) {
-        simulation->predators[i] = createAgent(canvas, "PREDATOR", 'X', 1);
-        if (!simulation->predators[i]) {
-            fprintf(stderr, "Failed to create predator\n");
-            destroySimulation(simulation);
-            return NULL;
-        }
+    size_t cells = simulation->numWorlds * canvas->numRows * canvas->numCols;
+    simulation->occupancy = calloc(cells, sizeof(uint8_t));
+    simulation->predatorCount = calloc(cells, sizeof(uint16_t));
+    simulation->preyCount = calloc(cells, sizeof(uint16_t));
+    simulation->firstPrey = malloc(cells * sizeof(uint32_t));
+    simulation->foods.cells = malloc(cells * sizeof(uint32_t));
+    simulation->worldFoods = calloc(simulation->numWorlds, sizeof(size_t));
+    if (!simulation->occupancy || !simulation->predatorCount || !simulation->preyCount ||
+        !simulation->firstPrey || !simulation->foods.cells || !simulation->worldFoods) {
+        fprintf(stderr, "Failed to allocate %zu worlds\n", simulation->numWorlds);
+        destroySimulation(simulation);
+        return NULL;
     }
-    for (size_t i = 0; i < MAX_PREY; i++) {
-        simulation->preys[i] = createAgent(canvas, "PREY", 'O', 0);
-        if (!simulation->preys[i]) {
-            fprintf(stderr, "Failed to create prey\n");
-            destroySimulation(simulation);
-            return NULL;
-        }
+    memset(simulation->firstPrey, 0xFF, cells * sizeof(uint32_t));
+    memset(simulation->foods.cells, 0xFF, cells * sizeof(uint32_t));
+
+    if (numThreads <= 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        numThreads = online > 0 ? (int)online : 1;
     }
-    for (size_t i = 0; i < simulation->numFoods; i++) {
-        simulation->foods[i] = createFood(canvas);
-        if (!simulation->foods[i]) {
-            fprintf(stderr, "Failed to create food\n");
-            destroySimulation(simulation);
-            return NULL;
-        }
+    simulation->numWorkers = (unsigned int)numThreads;
+    simulation->workers = calloc(simulation->numWorkers, sizeof(SimulationWorker));
+    if (numThreads > 1) {
+        simulation->pool = threadPoolCreate(numThreads, numThreads * 2);
+    }
+    if (!simulation->workers || (numThreads > 1 && !simulation->pool)) {
+        fprintf(stderr, "Failed to create simulation workers\n");
+        destroySimulation(simulation);
+        return NULL;
+    }
+
+    if (!reserveAgents(&simulation->predators, simulation->numWorlds * (size_t)params.initialPredators) ||
+        !reserveAgents(&simulation->preys, simulation->numWorlds * (size_t)params.initialPrey) ||
+        !reserveFoods(&simulation->foods, simulation->numWorlds * (size_t)params.maxFood) ||
+        !populateSimulation(simulation, canvas)) {
+        destroySimulation(simulation);
+        return NULL;
     }
 
     return simulation;
 }
 
+void recordGeneration(Simulation *simulation) {
+    if (simulation->historyCount == simulation->historyCapacity) {
+        size_t capacity = simulation->historyCapacity ? simulation->historyCapacity * 2 : 64;
+        if (!growColumn((void **)&simulation->history, sizeof(GenerationStats), capacity)) return;
+        simulation->historyCapacity = capacity;
+    }
+    GenerationStats *stats = &simulation->history[simulation->historyCount++];
+    stats->ticks = simulation->tick - simulation->generationStart;
+    summarizeFitness(&simulation->predators, &stats->predatorBest, &stats->predatorMean);
+    summarizeFitness(&simulation->preys, &stats->preyBest, &stats->preyMean);
+}
+
+/* Replaces every agent, network and food with fresh random ones. */
+void repopulateSimulation(Simulation *simulation, Canvas *canvas) {
+    clearAgents(&simulation->predators);
+    clearAgents(&simulation->preys);
+    clearFoods(&simulation->foods, canvas);
+    populateSimulation(simulation, canvas);
+}
+
+void beginGeneration(Simulation *simulation) {
+    simulation->generation++;
+    simulation->generationStart = simulation->tick;
+    if (simulation->telemetry) {
+        attachTelemetry(simulation, simulation->telemetry, simulation->telemetrySource, simulation->telemetryProducer);
+        simulation->catches = 0;
+        simulation->foodEaten = 0;
+    }
+}
+
+/*
+ * Ends the generation: islands trade migrants, the finished episode's
+ * fitness breeds the next generation's networks in place, then every agent
+ * and food restarts.
+ */
 void restartSimulation(Simulation *simulation, Canvas *canvas) {
-    for (size_t i = 0; i < simulation->numPredators; i++) {
-        destroyAgent(simulation->predators[i]);
-        simulation->predators[i] = createAgent(canvas, "PREDATOR", 'X', 1);
+    recordGeneration(simulation);
+    if (simulation->predatorIsland) {
+        migrate(simulation->predatorIsland, &simulation->predators);
+        migrate(simulation->preyIsland, &simulation->preys);
+    }
+    evolvePopulation(simulation);
+    Agents *species[2] = {&simulation->predators, &simulation->preys};
+    for (int s = 0; s < 2; s++) {
+        for (size_t i = 0; i < species[s]->count; i++) {
+            resetAgent(species[s], i, canvas);
+        }
+    }
+    clearFoods(&simulation->foods, canvas);
+    for (uint32_t w = 0; w < simulation->numWorlds; w++) {
+        stockWorld(simulation, canvas, w);
+    }
+    beginGeneration(simulation);
+}
+
+/* Restores a checkpoint written by checkpointSimulation; on failure the batch is repopulated from scratch. */
+int resumeSimulation(Simulation *simulation, Canvas *canvas, const char *path) {
+    size_t size = 0;
+    unsigned char *payload = checkpointRead(path, &size);
+    CheckpointReader reader = {payload, size, 0, 0};
+    int loaded = payload && loadSimulation(simulation, canvas, &reader);
+    free(payload);
+    if (!loaded) {
+        fprintf(stderr, "Failed to resume from %s, starting fresh\n", path);
+        repopulateSimulation(simulation, canvas);
+    }
+    return loaded;
+}
+
+size_t fittestAgent(const Agents *agents) {
+    size_t best = SIZE_MAX;
+    for (size_t i = 0; i < agents->count; i++) {
+        if (best == SIZE_MAX || agents->fitness[i] > agents->fitness[best]) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+/* Prints how far the int8 policy strays from nn on random observations. */
+NNQ8_Report reportQuantization(NN_t *nn, NNQ8_t *policy) {
+    NNQ8_Report report = {-1, -1, 0};
+    double *inputs = malloc(sizeof(double) * QUANTIZE_SAMPLES * nn->numInputs);
+    if (!inputs) {
+        fprintf(stderr, "Failed to allocate quantization samples\n");
+        return report;
+    }
+    rngUniformBatch(rngThread(), inputs, (size_t)QUANTIZE_SAMPLES * nn->numInputs);
+    report = NNQ8_compare(nn, policy, inputs, QUANTIZE_SAMPLES);
+    free(inputs);
+    return report;
+}
+
+void saveChampion(const Agents *agents, size_t i, const char *path) {
+    if (i == SIZE_MAX) return;
+    if (NN_save(agents->nn[i], path) != 0) {
+        fprintf(stderr, "Failed to save champion %s\n", path);
+        return;
     }
-    
-    for (size_t i = 0; i < simulation->numPreys; i++) {
-        destroyAgent(simulation->preys[i]);
-        simulation->preys[i] = createAgent(canvas, "PREY", 'O', 0);
+    if (agents->policy[i]) {
+        reportQuantization(agents->nn[i], agents->policy[i]);
     }
-    
-    for (size_t i = 0; i < simulation->numFoods; i++) {
-        destroyFood(simulation->foods[i]);
+}
+
+void saveChampions(Simulation *simulation) {
+    saveChampion(&simulation->predators, fittestAgent(&simulation->predators), "predator.nn");
+    saveChampion(&simulation->preys, fittestAgent(&simulation->preys), "prey.nn");
+}
+
+/* Quantizes a saved champion and reports the accuracy delta of the int8 path. */
+int quantizeModel(const char *modelPath) {
+    NN_t *nn = NN_load(modelPath, 1);
+    if (!nn) {
+        fprintf(stderr, "Failed to load model %s\n", modelPath);
+        return 1;
     }
-    simulation->numFoods = MAX_FOOD / 2;
-    for (size_t i = 0; i < simulation->numFoods; i++) {
-        simulation->foods[i] = createFood(canvas);
+    NNQ8_t *policy = NNQ8_quantize(nn);
+    NNQ8_Report report = {-1, -1, 0};
+    if (policy) {
+        report = reportQuantization(nn, policy);
+    }
+    NNQ8_destroy(policy);
+    NN_destroy(nn);
+    return report.maxAbsDelta < 0;
+}
+
+/*
+ * Builds a saved champion into a shared-object evaluator exporting
+ * COMPILED_SYMBOL, then loads it back and checks it against the
+ * interpreted network on random observations.
+ */
+int compileModel(const char *modelPath, const char *sharedPath) {
+    NN_t *nn = NN_load(modelPath, 1);
+    if (!nn) {
+        fprintf(stderr, "Failed to load model %s\n", modelPath);
+        return 1;
+    }
+    NNCompiled *compiled = NN_compile(nn, COMPILED_SYMBOL, sharedPath) == 0 ? NN_compiled_load(sharedPath, COMPILED_SYMBOL) : NULL;
+    double *inputs = malloc(sizeof(double) * COMPILE_SAMPLES * nn->numInputs);
+    int result = 1;
+    if (compiled && inputs) {
+        rngUniformBatch(rngThread(), inputs, (size_t)COMPILE_SAMPLES * nn->numInputs);
+        double delta = NN_compiled_compare(nn, compiled, inputs, COMPILE_SAMPLES);
+        printf("Compiled %s into %s: max |delta| = %g over %d samples\n", modelPath, sharedPath, delta, COMPILE_SAMPLES);
+        result = delta < 0 || delta > 1e-9;
+    }
+    free(inputs);
+    NN_compiled_close(compiled);
+    NN_destroy(nn);
+    return result;
+}
+
+/* Only world 0 of the batch is rendered. */
+void drawAgents(Canvas *canvas, const Agents *agents) {
+    for (size_t i = 0; i < agents->count; i++) {
+        if (agents->world[i] != 0) continue;
+        canvas->state.cells[agents->y[i]][agents->x[i]] = agents->symbol;
+        canvas->state.colors[agents->y[i]][agents->x[i]] = agents->color;
     }
 }
 
 void drawSimulation(Canvas *canvas, Simulation *simulation) {
-    for (size_t i = 0; i < simulation->numPredators; i++) {
-        Entity *entity = simulation->predators[i]->entity;
-        canvas->state.cells[entity->cell.pos.y][entity->cell.pos.x] = entity->cell.c;
-        canvas->state.colors[entity->cell.pos.y][entity->cell.pos.x] = entity->color;
+    drawAgents(canvas, &simulation->predators);
+    drawAgents(canvas, &simulation->preys);
+    for (size_t i = 0; i < simulation->foods.count; i++) {
+        if (simulation->foods.world[i] != 0) continue;
+        canvas->state.cells[simulation->foods.y[i]][simulation->foods.x[i]] = '*';
+        canvas->state.colors[simulation->foods.y[i]][simulation->foods.x[i]] = (Color){0,255,255};
+    }
+}
+
+static volatile sig_atomic_t stopRequested = 0;
+
+void handleStop(int signum) {
+    (void)signum;
+    stopRequested = 1;
+}
+
+uint64_t islandSeed(const IslandOptions *islands) {
+    return (uint64_t)time(NULL) ^ ((uint64_t)islands->id * 0x9E3779B97F4A7C15ULL);
+}
+
+/*
+ * Opens the island's telemetry and checkpoint sinks and resumes from
+ * options->resume when given. Returns 0 if the simulation cannot run.
+ */
+int prepareRun(Simulation *simulation, Canvas *canvas, const RunOptions *options, const IslandOptions *islands) {
+    if (options->learn && !attachLearners(simulation)) {
+        fprintf(stderr, "Failed to start learners\n");
+        return 0;
     }
-    for (size_t i = 0; i < simulation->numPreys; i++) {
-        Entity *entity = simulation->preys[i]->entity;
-        canvas->state.cells[entity->cell.pos.y][entity->cell.pos.x] = entity->cell.c;
-        canvas->state.colors[entity->cell.pos.y][entity->cell.pos.x] = entity->color;
+    char path[4096];
+    if (options->resume) {
+        islandPath(path, sizeof(path), options->resume, islands->id);
+        resumeSimulation(simulation, canvas, path);
     }
-    for (size_t i = 0; i < simulation->numFoods; i++) {
-        Entity *entity = simulation->foods[i]->entity;
-        canvas->state.cells[entity->cell.pos.y][entity->cell.pos.x] = entity->cell.c;
-        canvas->state.colors[entity->cell.pos.y][entity->cell.pos.x] = entity->color;
+    if (options->checkpoint) {
+        islandPath(path, sizeof(path), options->checkpoint, islands->id);
+        simulation->checkpointer = checkpointerCreate(path);
     }
+    Telemetry *telemetry = openTelemetry(options->telemetry, islands->id, 1);
+    if (telemetry) {
+        attachTelemetry(simulation, telemetry, islands->id, 0);
+    }
+    return 1;
+}
+
+/* Writes a final checkpoint and waits for it before tearing the simulation down. */
+void finishRun(Simulation *simulation, const Canvas *canvas) {
+    Telemetry *telemetry = simulation->telemetry;
+    Checkpointer *checkpointer = simulation->checkpointer;
+    reportTelemetry(simulation);
+    checkpointSimulation(simulation, canvas);
+    destroySimulation(simulation);
+    checkpointerDestroy(checkpointer);
+    telemetryClose(telemetry);
+}
+
+/* Headless island worker: steps as fast as it can until the renderer stops or exits. */
+int runIsland(uint8_t rows, uint8_t cols, const RunOptions *options, const IslandOptions *islands) {
+    signal(SIGTERM, handleStop);
+    rngSetSeed(islandSeed(islands));
+
+    Canvas *canvas = initCanvas(rows, cols, ' ');
+    if (!canvas) {
+        fprintf(stderr, "Failed to initialize canvas\n");
+        return 1;
+    }
+
+    Simulation *simulation = createSimulation(canvas, options->numWorlds, options->numThreads);
+    if (!simulation || !attachIslands(simulation, islands) || !prepareRun(simulation, canvas, options, islands)) {
+        fprintf(stderr, "Failed to create island %u\n", islands->id);
+        if (simulation) destroySimulation(simulation);
+        freeCanvas(canvas);
+        return 1;
+    }
+
+    pid_t renderer = getppid();
+    while (!stopRequested && getppid() == renderer) {
+        updateSimulation(simulation, canvas);
+        if (generationOver(simulation)) {
+            reportTelemetry(simulation);
+            restartSimulation(simulation, canvas);
+        }
+    }
+
+    finishRun(simulation, canvas);
+    freeCanvas(canvas);
+    return 0;
 }
 
-int run(uint8_t frameRate, uint8_t rows, uint8_t cols) {
+typedef struct {
+    Canvas *canvas;
+    Simulation *simulation;
+} Episode;
+
+typedef struct {
+    Episode *episodes; /* one per steady-state worker */
+    Telemetry *telemetry;
+    unsigned int source; /* added to the worker index to tag records */
+    uint8_t rows;
+    uint8_t cols;
+    int predators;     /* which species the genomes drive */
+} EpisodeContext;
+
+/*
+ * One headless single-world episode with every agent of the evolved species
+ * running the genome. Ends after episode_ticks, when the species dies out,
+ * or when its total health has not moved for stagnation_ticks.
+ */
+static double evaluateEpisode(const double *genome, size_t genomeSize, uint64_t seed, unsigned int worker, void *context) {
+    EpisodeContext *episodes = (EpisodeContext *)context;
+    Episode *episode = &episodes->episodes[worker];
+    rngSeed(rngThread(), seed, 0);
+    if (!episode->simulation) {
+        episode->canvas = initCanvas(episodes->rows, episodes->cols, ' ');
+        episode->simulation = episode->canvas ? createSimulation(episode->canvas, 1, 1) : NULL;
+        if (!episode->simulation) return 0;
+        if (episodes->telemetry) {
+            attachTelemetry(episode->simulation, episodes->telemetry, episodes->source + worker, worker);
+        }
+    } else {
+        repopulateSimulation(episode->simulation, episode->canvas);
+        beginGeneration(episode->simulation);
+    }
+
+    Simulation *simulation = episode->simulation;
+    Agents *agents = episodes->predators ? &simulation->predators : &simulation->preys;
+    for (size_t i = 0; i < agents->count; i++) {
+        memcpy(agents->nn[i]->params, genome, sizeof(double) * genomeSize);
+        if (agents->policy[i]) {
+            NNQ8_requantize(agents->policy[i], agents->nn[i]);
+        }
+    }
+
+    unsigned long long lastTotal = 0;
+    size_t still = 0;
+    for (size_t t = 0; t < (size_t)params.episodeTicks && anyAlive(agents); t++) {
+        updateSimulation(simulation, episode->canvas);
+        unsigned long long total = 0;
+        for (size_t i = 0; i < agents->count; i++) {
+            total += agents->health[i];
+        }
+        if (total != lastTotal) {
+            lastTotal = total;
+            still = 0;
+        } else if (++still >= (size_t)params.stagnationTicks) {
+            break;
+        }
+    }
+
+    reportTelemetry(simulation);
+    double fitness = 0;
+    for (size_t i = 0; i < agents->count; i++) {
+        fitness += agents->fitness[i];
+    }
+    return agents->count ? fitness / (double)agents->count : 0;
+}
+
+/*
+ * Evolves one species with the steady-state engine, stores the best fitness
+ * in best and saves the best genome to path unless path is NULL. Each
+ * evaluator records its episodes as telemetry source source + worker, so
+ * telemetry needs numThreads producers.
+ */
+int evolveSteady(uint8_t rows, uint8_t cols, size_t evaluations, int numThreads, int predators, const char *path, uint64_t seed,
+                 Telemetry *telemetry, unsigned int source, double *best) {
+    size_t population = (size_t)params.steadyPopulation;
+    NN_t *brain = createBrain();
+    double *initial = brain ? malloc(sizeof(double) * (population ? population : 1) * brain->numParams) : NULL;
+    EpisodeContext context = {calloc((size_t)numThreads, sizeof(Episode)), telemetry, source, rows, cols, predators};
+    if (!brain || !initial || !context.episodes) {
+        fprintf(stderr, "Failed to allocate steady-state evolution\n");
+        NN_destroy(brain);
+        free(initial);
+        free(context.episodes);
+        return 1;
+    }
+    for (size_t i = 0; i < population; i++) {
+        NN_t *nn = createBrain();
+        if (!nn) break;
+        memcpy(initial + i * brain->numParams, nn->params, sizeof(double) * brain->numParams);
+        NN_destroy(nn);
+    }
+
+    int result = 1;
+    SteadyState *steady = steadyCreate(population, brain->numParams, initial, numThreads, breedingConfig(), evaluateEpisode, &context, seed);
+    if (steady && steadyStart(steady, evaluations) == 0) {
+        steadyWait(steady);
+        double fitness = 0;
+        if (steadyBest(steady, brain->params, &fitness) != SIZE_MAX) {
+            *best = fitness;
+            result = 0;
+            if (path) {
+                printf("Best %s fitness %.1f after %zu evaluations\n", predators ? "predator" : "prey", fitness, steady->evaluations);
+                result = NN_save(brain, path) != 0;
+            }
+        }
+    }
+
+    steadyDestroy(steady);
+    for (int w = 0; w < numThreads; w++) {
+        if (context.episodes[w].simulation) destroySimulation(context.episodes[w].simulation);
+        if (context.episodes[w].canvas) freeCanvas(context.episodes[w].canvas);
+    }
+    free(context.episodes);
+    free(initial);
+    NN_destroy(brain);
+    return result;
+}
+
+/* Prey episodes are tagged with telemetry sources numThreads and up. */
+int runSteady(uint8_t rows, uint8_t cols, size_t evaluations, int numThreads, const char *telemetryPath, const IslandOptions *islands) {
+    if (numThreads <= 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        numThreads = online > 0 ? (int)online : 1;
+    }
+    uint64_t seed = islandSeed(islands);
+    rngSetSeed(seed);
+    Telemetry *telemetry = openTelemetry(telemetryPath, 0, (unsigned int)numThreads);
+    double best = 0;
+    int result = evolveSteady(rows, cols, evaluations, numThreads, 1, "predator.nn", seed, telemetry, 0, &best);
+    result = evolveSteady(rows, cols, evaluations, numThreads, 0, "prey.nn", seed + 1, telemetry, (unsigned int)numThreads, &best) || result;
+    telemetryClose(telemetry);
+    return result;
+}
+
+typedef struct {
+    size_t field;
+    double *values; /* grid points, or NULL to draw from [lo, hi] */
+    size_t count;
+    double lo;
+    double hi;
+} SweepAxis;
+
+typedef struct {
+    double predatorBest;
+    double preyBest;
+    double seconds;
+} SweepResult;
+
+/*
+ * A hyperparameter sweep: every axis names one parameter, and each job
+ * evolves both species headlessly with the steady-state GA under one
+ * assignment. Without samples the jobs are the full grid over the axes'
+ * points; with samples, each job draws every axis at random from its
+ * points or range.
+ */
+typedef struct {
+    SweepAxis axes[NUM_PARAMS];
+    size_t numAxes;
+    size_t samples;
+    size_t evaluations;
+    uint64_t seed;
+    uint8_t rows;
+    uint8_t cols;
+    size_t numJobs;
+    double *settings; /* numJobs x numAxes */
+    SweepResult *results;
+    int *status;
+} Sweep;
+
+/* Parses NAME=V1,V2,... (grid points) or NAME=LO:HI (random range) into a new axis. */
+int addSweepAxis(Sweep *sweep, const char *spec) {
+    const char *equals = strchr(spec, '=');
+    int field = equals ? findParam(spec, (size_t)(equals - spec)) : -1;
+    if (field < 0 || sweep->numAxes == NUM_PARAMS) {
+        fprintf(stderr, "Invalid sweep axis %s\n", spec);
+        return -1;
+    }
+    SweepAxis *axis = &sweep->axes[sweep->numAxes];
+    memset(axis, 0, sizeof(SweepAxis));
+    axis->field = (size_t)field;
+
+    const char *text = equals + 1;
+    char *end = NULL;
+    if (strchr(text, ':')) {
+        axis->lo = strtod(text, &end);
+        if (end == text || *end != ':') goto invalid;
+        text = end + 1;
+        axis->hi = strtod(text, &end);
+        if (end == text || *end != '\0' || !(axis->lo >= 0) || !(axis->hi >= axis->lo)) goto invalid;
+    } else {
+        size_t capacity = 1;
+        for (const char *c = text; *c; c++) capacity += *c == ',';
+        axis->values = malloc(sizeof(double) * capacity);
+        if (!axis->values) goto invalid;
+        while (1) {
+            double value = strtod(text, &end);
+            if (end == text || (*end != ',' && *end != '\0') || !(value >= 0)) goto invalid;
+            axis->values[axis->count++] = value;
+            if (*end == '\0') break;
+            text = end + 1;
+        }
+    }
+    sweep->numAxes++;
+    return 0;
+
+invalid:
+    fprintf(stderr, "Invalid sweep axis %s\n", spec);
+    free(axis->values);
+    axis->values = NULL;
+    return -1;
+}
+
+void freeSweep(Sweep *sweep) {
+    for (size_t a = 0; a < sweep->numAxes; a++) {
+        free(sweep->axes[a].values);
+    }
+    free(sweep->settings);
+    free(sweep->results);
+    free(sweep->status);
+}
+
+/* Lays out every job's assignment up front so workers only read it. */
+static int planSweep(Sweep *sweep) {
+    size_t numJobs = sweep->samples;
+    if (numJobs == 0) {
+        numJobs = 1;
+        for (size_t a = 0; a < sweep->numAxes; a++) {
+            if (!sweep->axes[a].values) {
+                fprintf(stderr, "Sweep ranges need --samples\n");
+                return -1;
+            }
+            numJobs *= sweep->axes[a].count;
+        }
+    }
+    sweep->numJobs = numJobs;
+    sweep->settings = malloc(sizeof(double) * (numJobs * sweep->numAxes + 1));
+    sweep->results = calloc(numJobs, sizeof(SweepResult));
+    sweep->status = calloc(numJobs, sizeof(int));
+    if (!sweep->settings || !sweep->results || !sweep->status) {
+        fprintf(stderr, "Failed to allocate sweep of %zu jobs\n", numJobs);
+        return -1;
+    }
+
+    Rng rng;
+    rngSeed(&rng, sweep->seed, 0);
+    for (size_t job = 0; job < numJobs; job++) {
+        size_t rest = job;
+        for (size_t a = 0; a < sweep->numAxes; a++) {
+            const SweepAxis *axis = &sweep->axes[a];
+            double *setting = &sweep->settings[job * sweep->numAxes + a];
+            if (sweep->samples == 0) {
+                *setting = axis->values[rest % axis->count];
+                rest /= axis->count;
+            } else if (axis->values) {
+                *setting = axis->values[rngBelow(&rng, (uint32_t)axis->count)];
+            } else {
+                *setting = axis->lo + (axis->hi - axis->lo) * rngUniform(&rng);
+            }
+        }
+    }
+    return 0;
+}
+
+static int runSweepJob(size_t job, void *result, void *context) {
+    Sweep *sweep = (Sweep *)context;
+    SweepResult *out = (SweepResult *)result;
+    for (size_t a = 0; a < sweep->numAxes; a++) {
+        *paramValue(&params, sweep->axes[a].field) = sweep->settings[job * sweep->numAxes + a];
+    }
+    uint64_t seed = sweep->seed + 2 * job + 1;
+    rngSetSeed(seed);
+    double start = monotonicSeconds();
+    int failed = evolveSteady(sweep->rows, sweep->cols, sweep->evaluations, 1, 1, NULL, seed, NULL, 0, &out->predatorBest);
+    failed = evolveSteady(sweep->rows, sweep->cols, sweep->evaluations, 1, 0, NULL, seed + 1, NULL, 0, &out->preyBest) || failed;
+    out->seconds = monotonicSeconds() - start;
+    return failed;
+}
+
+static void collectSweepJob(size_t job, int status, const void *result, void *context) {
+    Sweep *sweep = (Sweep *)context;
+    sweep->status[job] = status;
+    if (result) {
+        sweep->results[job] = *(const SweepResult *)result;
+    }
+    fprintf(stderr, "Sweep job %zu/%zu %s\n", job + 1, sweep->numJobs, status == 0 ? "done" : "failed");
+}
+
+int writeSweepResults(const Sweep *sweep, const char *path) {
+    FILE *file = fopen(path, "w");
+    if (!file) {
+        perror("Failed to open sweep results");
+        return -1;
+    }
+    fprintf(file, "job");
+    for (size_t a = 0; a < sweep->numAxes; a++) {
+        fprintf(file, ",%s", paramFields[sweep->axes[a].field].name);
+    }
+    fprintf(file, ",predator_best,prey_best,seconds,status\n");
+    for (size_t job = 0; job < sweep->numJobs; job++) {
+        fprintf(file, "%zu", job);
+        for (size_t a = 0; a < sweep->numAxes; a++) {
+            fprintf(file, ",%g", sweep->settings[job * sweep->numAxes + a]);
+        }
+        const SweepResult *r = &sweep->results[job];
+        fprintf(file, ",%.3f,%.3f,%.2f,%s\n", r->predatorBest, r->preyBest, r->seconds, sweep->status[job] == 0 ? "ok" : "failed");
+    }
+    return fclose(file) == 0 ? 0 : -1;
+}
+
+/* Fans the sweep's jobs out over numProcesses worker processes and writes one results table. */
+int runSweep(Sweep *sweep, int numProcesses, const char *resultsPath) {
+    if (planSweep(sweep) != 0) return 1;
+    fprintf(stderr, "Sweeping %zu jobs of %zu evaluations per species\n", sweep->numJobs, sweep->evaluations);
+    int failed = processPoolRun(sweep->numJobs, numProcesses, sizeof(SweepResult), runSweepJob, collectSweepJob, sweep);
+    if (failed < 0 || writeSweepResults(sweep, resultsPath) != 0) return 1;
+    printf("Wrote %zu sweep results to %s (%d failed)\n", sweep->numJobs, resultsPath, failed);
+    return failed > 0;
+}
+
+int run(uint8_t frameRate, uint8_t rows, uint8_t cols, const RunOptions *options, const IslandOptions *islands) {
     signal(SIGINT, handleSignal);
-    srand((unsigned)time(NULL));
+    rngSetSeed(islandSeed(islands));
 
     Canvas *canvas = initCanvas(rows, cols, ' ');
     if (!canvas) {
@@ -406,12 +1910,20 @@ int run(uint8_t frameRate, uint8_t rows, uint8_t cols) {
         return 1;
     }
 
-    Simulation *simulation = createSimulation(canvas);
+    Simulation *simulation = createSimulation(canvas, options->numWorlds, options->numThreads);
     if (!simulation) {
         fprintf(stderr, "Failed to create simulation\n");
         freeCanvas(canvas);
         return 1;
     }
+    if (!attachIslands(simulation, islands)) {
+        fprintf(stderr, "Failed to join island ring, running alone\n");
+    }
+    if (!prepareRun(simulation, canvas, options, islands)) {
+        destroySimulation(simulation);
+        freeCanvas(canvas);
+        return 1;
+    }
 
     Clock *clock = createClock();
     initClock(clock, frameRate, frameRate);
@@ -441,9 +1953,12 @@ int run(uint8_t frameRate, uint8_t rows, uint8_t cols) {
             printf("\033[H");
             printCanvas(canvas);
 
-            if (!checkAliveEntities(simulation)) {
-                printf("All entities have died. Restarting simulation...\n");
-                sleep(10); 
+            if (generationOver(simulation)) {
+                reportTelemetry(simulation);
+                if (!checkAliveEntities(simulation)) {
+                    printf("All entities have died. Restarting simulation...\n");
+                    sleep(10);
+                }
                 restartSimulation(simulation, canvas);
             }
         }
@@ -451,14 +1966,146 @@ int run(uint8_t frameRate, uint8_t rows, uint8_t cols) {
   }
     setRawMode(0);
 
-    destroySimulation(simulation);
+    saveChampions(simulation);
+    finishRun(simulation, canvas);
     destroyClock(clock);
     freeCanvas(canvas);
 
     return 0;
 }
 
-int main(void) {
-    return run(FPS, 45, 155);
+/*
+ * --islands N forks N - 1 headless island workers next to the rendered one;
+ * each evolves its own population and, at every generation turnover,
+ * migrates genomes around the ring through sockets in --island-dir.
+ * --worlds N steps N worlds per process as one batch; only the first is drawn. --threads N sets the workers that
+ * step each batch. --steady N skips rendering and instead runs N headless
+ * episode evaluations per species through the steady-state GA, saving the
+ * best genomes as predator.nn and prey.nn. --learner makes each species act
+ * with one shared network trained off-thread from replayed experience.
+ * --telemetry PATH records fitness, population, catch, food and speed
+ * statistics as CSV, or as binary records when PATH ends in .bin.
+ * Checkpointing is off unless --checkpoint PATH is given; then the batch is
+ * checkpointed every CHECKPOINT_INTERVAL ticks and on exit to PATH (PATH.ID
+ * for other islands) by a background writer. --resume PATH continues from
+ * such a checkpoint.
+ * --set NAME=VALUE overrides one runtime parameter (see paramFields).
+ * --sweep NAME=V1,V2,... or NAME=LO:HI adds a sweep axis; the sweep runs
+ * the full grid, or --samples random draws, as headless steady-state jobs
+ * (--steady evaluations per species, default SWEEP_EVALUATIONS) on --jobs
+ * worker processes, and writes one row per job to --results.
+ * --compile MODEL SHARED turns a saved champion such as predator.nn into a
+ * specialized shared-object evaluator. --quantize MODEL reports how far
+ * its int8 policy strays from it; with QUANTIZED_POLICY set, saving the
+ * champions reports the same for the policies the agents ran.
+ */
+int main(int argc, char **argv) {
+    IslandOptions islands = {0, 1, "/tmp"};
+    RunOptions options = {WORLDS, THREADS, 0, NULL, NULL, NULL};
+    size_t steadyEvaluations = 0;
+    Sweep sweep = {0};
+    int numProcesses = 0;
+    const char *resultsPath = SWEEP_RESULTS;
+    const char *compileModelPath = NULL;
+    const char *compileSharedPath = NULL;
+    const char *quantizeModelPath = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--islands") == 0 && i + 1 < argc) {
+            islands.count = (unsigned int)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--island-dir") == 0 && i + 1 < argc) {
+            islands.dir = argv[++i];
+        } else if (strcmp(argv[i], "--worlds") == 0 && i + 1 < argc) {
+            options.numWorlds = (size_t)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            options.numThreads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--telemetry") == 0 && i + 1 < argc) {
+            options.telemetry = argv[++i];
+        } else if (strcmp(argv[i], "--checkpoint") == 0 && i + 1 < argc) {
+            options.checkpoint = argv[++i];
+        } else if (strcmp(argv[i], "--resume") == 0 && i + 1 < argc) {
+            options.resume = argv[++i];
+        } else if (strcmp(argv[i], "--learner") == 0) {
+            options.learn = 1;
+        } else if (strcmp(argv[i], "--compile") == 0 && i + 2 < argc) {
+            compileModelPath = argv[++i];
+            compileSharedPath = argv[++i];
+        } else if (strcmp(argv[i], "--quantize") == 0 && i + 1 < argc) {
+            quantizeModelPath = argv[++i];
+        } else if (strcmp(argv[i], "--set") == 0 && i + 1 < argc) {
+            if (setParam(argv[++i]) != 0) return 1;
+        } else if (strcmp(argv[i], "--sweep") == 0 && i + 1 < argc) {
+            if (addSweepAxis(&sweep, argv[++i]) != 0) {
+                freeSweep(&sweep);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--samples") == 0 && i + 1 < argc) {
+            sweep.samples = (size_t)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--jobs") == 0 && i + 1 < argc) {
+            numProcesses = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--results") == 0 && i + 1 < argc) {
+            resultsPath = argv[++i];
+        } else if (strcmp(argv[i], "--steady") == 0 && i + 1 < argc) {
+            steadyEvaluations = (size_t)atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "Usage: %s [--islands N] [--island-dir DIR] [--worlds N] [--threads N] [--steady EVALUATIONS] [--learner] [--telemetry PATH]\n"
+                            "       [--checkpoint PATH] [--resume PATH] [--set NAME=VALUE]\n"
+                            "       [--sweep NAME=V1,V2,...|NAME=LO:HI] [--samples N] [--jobs N] [--results PATH]\n"
+                            "       [--compile MODEL SHARED] [--quantize MODEL]\n", argv[0]);
+            freeSweep(&sweep);
+            return 1;
+        }
+    }
+    if (islands.count < 1) {
+        islands.count = 1;
+    }
+    if (compileModelPath) {
+        freeSweep(&sweep);
+        return compileModel(compileModelPath, compileSharedPath);
+    }
+    if (quantizeModelPath) {
+        freeSweep(&sweep);
+        return quantizeModel(quantizeModelPath);
+    }
+    if (sweep.numAxes > 0) {
+        sweep.evaluations = steadyEvaluations > 0 ? steadyEvaluations : SWEEP_EVALUATIONS;
+        sweep.seed = islandSeed(&islands);
+        sweep.rows = 45;
+        sweep.cols = 155;
+        int result = runSweep(&sweep, numProcesses, resultsPath);
+        freeSweep(&sweep);
+        return result;
+    }
+    if (steadyEvaluations > 0) {
+        return runSteady(45, 155, steadyEvaluations, options.numThreads, options.telemetry, &islands);
+    }
+
+    pid_t *workers = calloc(islands.count, sizeof(pid_t));
+    if (!workers) {
+        fprintf(stderr, "Failed to allocate island workers\n");
+        return 1;
+    }
+    for (unsigned int id = 1; id < islands.count; id++) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            free(workers);
+            islands.id = id;
+            return runIsland(45, 155, &options, &islands);
+        }
+        if (pid < 0) {
+            perror("Failed to fork island worker");
+        }
+        workers[id] = pid;
+    }
+
+    int result = run(FPS, 45, 155, &options, &islands);
+
+    for (unsigned int id = 1; id < islands.count; id++) {
+        if (workers[id] > 0) {
+            kill(workers[id], SIGTERM);
+            waitpid(workers[id], NULL, 0);
+        }
+    }
+    free(workers);
+    return result;
 }
 
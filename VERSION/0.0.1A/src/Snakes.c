@@ -25,7 +25,6 @@ Apple *createApple(Canvas *canvas) {
   apple->apple->cell.pos.x = rand() % canvas->numCols;
   apple->apple->cell.pos.y = rand() % canvas->numRows;
   addEntity(canvas, apple->apple);
-  printf("Apple created at: (%d, %d)\n", apple->apple->cell.pos.x, apple->apple->cell.pos.y); 
   return apple;
 }
 
@@ -0,0 +1,129 @@
+#define main predPreySimMain
+#include "../src/PredPreySim.c"
+#undef main
+
+#define TEST_WORLDS 3
+#define TEST_TICKS 150
+#define CHECKPOINT_FILE "test_checkpoint.ckpt"
+
+static uint64_t hashSimulation(const Simulation *simulation) {
+    uint64_t hash = NN_model_checksum(&simulation->tick, sizeof(simulation->tick));
+    hash = hash * 31 + simulation->generation;
+    const Agents *species[2] = {&simulation->predators, &simulation->preys};
+    for (int s = 0; s < 2; s++) {
+        for (size_t i = 0; i < species[s]->count; i++) {
+            hash = hash * 31 + NN_model_checksum(species[s]->nn[i]->params, sizeof(double) * species[s]->nn[i]->numParams);
+            hash = hash * 31 + species[s]->x[i] + 256u * species[s]->y[i] + 65536u * species[s]->health[i];
+        }
+    }
+    for (size_t i = 0; i < simulation->foods.count; i++) {
+        hash = hash * 31 + simulation->foods.x[i] + 256u * simulation->foods.y[i];
+    }
+    return hash;
+}
+
+/* Runs past the checkpoint through one more turnover, so breeding sees the restored state too. */
+static uint64_t finishGeneration(Simulation *simulation, Canvas *canvas) {
+    for (int t = 0; t < TEST_TICKS; t++) {
+        updateSimulation(simulation, canvas);
+    }
+    restartSimulation(simulation, canvas);
+    for (int t = 0; t < TEST_TICKS; t++) {
+        updateSimulation(simulation, canvas);
+    }
+    return hashSimulation(simulation);
+}
+
+static int corrupt(const char *path, long offset) {
+    FILE *file = fopen(path, "r+b");
+    if (!file) return 1;
+    fseek(file, offset, SEEK_SET);
+    int byte = fgetc(file);
+    fseek(file, offset, SEEK_SET);
+    fputc(byte ^ 0x5a, file);
+    fclose(file);
+    return 0;
+}
+
+/*
+ * A checkpoint whose checksum holds but whose contents fail validation
+ * (here a prey in a world the batch does not have) must leave nothing of
+ * itself behind: the fresh start keeps its own tick, generation and history.
+ */
+static int checkInvalidResume(Canvas *canvas) {
+    Simulation *invalid = createSimulation(canvas, TEST_WORLDS, 1);
+    if (!invalid) return 1;
+    for (int t = 0; t < TEST_TICKS; t++) {
+        updateSimulation(invalid, canvas);
+    }
+    restartSimulation(invalid, canvas);
+    invalid->preys.world[invalid->preys.count - 1] = TEST_WORLDS;
+    invalid->checkpointer = checkpointerCreate(CHECKPOINT_FILE);
+    checkpointSimulation(invalid, canvas);
+    checkpointerDestroy(invalid->checkpointer);
+    invalid->checkpointer = NULL;
+    destroySimulation(invalid);
+
+    Simulation *fresh = createSimulation(canvas, TEST_WORLDS, 1);
+    if (!fresh) return 1;
+    size_t generation = fresh->generation;
+    int failed = 0;
+    if (resumeSimulation(fresh, canvas, CHECKPOINT_FILE) || fresh->tick != 0 || fresh->generation != generation ||
+        fresh->historyCount != 0 || fresh->preys.count == 0) {
+        fprintf(stderr, "Invalid checkpoint leaked into the fresh start\n");
+        failed = 1;
+    }
+    destroySimulation(fresh);
+    return failed;
+}
+
+int main(void) {
+    Canvas *canvas = initCanvas(25, 40, ' ');
+    if (!canvas) return 1;
+
+    rngSetSeed(11);
+    Simulation *original = createSimulation(canvas, TEST_WORLDS, 1);
+    if (!original) return 1;
+    for (int t = 0; t < TEST_TICKS; t++) {
+        updateSimulation(original, canvas);
+    }
+    restartSimulation(original, canvas);
+    for (int t = 0; t < TEST_TICKS; t++) {
+        updateSimulation(original, canvas);
+    }
+    original->checkpointer = checkpointerCreate(CHECKPOINT_FILE);
+    checkpointSimulation(original, canvas);
+    checkpointerDestroy(original->checkpointer);
+    original->checkpointer = NULL;
+    size_t tick = original->tick;
+    size_t historyCount = original->historyCount;
+    uint64_t expected = finishGeneration(original, canvas);
+    destroySimulation(original);
+
+    int failed = 0;
+    rngSetSeed(99);
+    Simulation *resumed = createSimulation(canvas, TEST_WORLDS, 1);
+    if (!resumed) return 1;
+    if (!resumeSimulation(resumed, canvas, CHECKPOINT_FILE) || resumed->tick != tick || resumed->historyCount != historyCount) {
+        fprintf(stderr, "Checkpoint did not restore the tick and generation history\n");
+        failed = 1;
+    } else if (finishGeneration(resumed, canvas) != expected) {
+        fprintf(stderr, "Resumed simulation diverged from the original\n");
+        failed = 1;
+    }
+    destroySimulation(resumed);
+
+    if (corrupt(CHECKPOINT_FILE, 100) != 0) return 1;
+    Simulation *fresh = createSimulation(canvas, TEST_WORLDS, 1);
+    if (!fresh) return 1;
+    if (resumeSimulation(fresh, canvas, CHECKPOINT_FILE) || fresh->predators.count == 0 || fresh->preys.count == 0) {
+        fprintf(stderr, "Corrupt checkpoint was not rejected for a fresh start\n");
+        failed = 1;
+    }
+    destroySimulation(fresh);
+    failed |= checkInvalidResume(canvas);
+    unlink(CHECKPOINT_FILE);
+
+    freeCanvas(canvas);
+    return failed;
+}
@@ -0,0 +1,69 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "../utils/NNS/NN_codegen.h"
+#include "../utils/Random/rng.h"
+
+#define SHARED_PATH "./test_codegen.so"
+#define SOURCE_PATH SHARED_PATH ".c"
+#define SYMBOL "test_forward"
+#define NUM_INPUTS 6
+#define NUM_HIDDEN 9
+#define NUM_OUTPUT 4
+#define NUM_SAMPLES 512
+
+static double unsupported(double x) {
+    return x * x;
+}
+
+/* The compiled evaluator must reproduce NN_infer on a layer that mixes every supported activation. */
+int main(void) {
+    ActivationFunction hidden[NUM_HIDDEN], hiddenDerivatives[NUM_HIDDEN];
+    ActivationFunction output[NUM_OUTPUT], outputDerivatives[NUM_OUTPUT];
+    ActivationFunction kinds[3] = {sigmoid, relu, tanh_activation};
+    ActivationFunction derivatives[3] = {sigmoid_derivative, relu_derivative, tanh_derivative};
+    for (int i = 0; i < NUM_HIDDEN; i++) {
+        hidden[i] = kinds[i % 3];
+        hiddenDerivatives[i] = derivatives[i % 3];
+    }
+    for (int i = 0; i < NUM_OUTPUT; i++) {
+        output[i] = linear;
+        outputDerivatives[i] = linear_derivative;
+    }
+    rngSetSeed(5);
+    NN_t *nn = NN_create(NUM_INPUTS, NUM_HIDDEN, NUM_OUTPUT, hidden, hiddenDerivatives, output, outputDerivatives, 0.1, 0.5);
+    double *inputs = malloc(sizeof(double) * NUM_SAMPLES * NUM_INPUTS);
+    if (!nn || !inputs) return 1;
+    /* Scaled to [-8, 8) so every activation sees both signs and its saturated range. */
+    rngUniformBatch(rngThread(), inputs, (size_t)NUM_SAMPLES * NUM_INPUTS);
+    for (int i = 0; i < NUM_SAMPLES * NUM_INPUTS; i++) {
+        inputs[i] = inputs[i] * 16 - 8;
+    }
+
+    int failed = 0;
+    NNCompiled *compiled = NN_compile(nn, SYMBOL, SHARED_PATH) == 0 ? NN_compiled_load(SHARED_PATH, SYMBOL) : NULL;
+    unlink(SHARED_PATH);
+    unlink(SOURCE_PATH);
+    if (!compiled) {
+        fprintf(stderr, "Failed to compile and load the network\n");
+        failed = 1;
+    } else {
+        double delta = NN_compiled_compare(nn, compiled, inputs, NUM_SAMPLES);
+        if (delta < 0 || delta > 1e-9) {
+            fprintf(stderr, "Compiled network strays %g from NN_infer\n", delta);
+            failed = 1;
+        }
+    }
+    NN_compiled_close(compiled);
+
+    nn->hiddenActivations[0] = unsupported;
+    if (NN_codegen(nn, SYMBOL, stdout) == 0) {
+        fprintf(stderr, "Generated code for a custom activation function\n");
+        failed = 1;
+    }
+
+    free(inputs);
+    NN_destroy(nn);
+    return failed;
+}
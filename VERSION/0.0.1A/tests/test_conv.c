@@ -0,0 +1,91 @@
+#include <stdio.h>
+#include <string.h>
+#include "../utils/NNS/NN_conv.h"
+#include "../utils/Random/rng.h"
+
+#define CHANNELS 4
+#define SIZE 9
+#define FILTERS 5
+#define STEP 1e-6
+#define TOLERANCE 1e-6
+
+/* Loss is a fixed weighted sum of the pooled features, so dLoss/dPooled is coefficients. */
+static double loss(NNConv2D *conv, NNPool2D *pool, const double *input, const double *coefficients) {
+    NNConv2D_forward(conv, input);
+    NNPool2D_forward(pool, conv->output);
+    double sum = 0;
+    for (unsigned int i = 0; i < NNPool2D_output_size(pool); i++) {
+        sum += coefficients[i] * pool->output[i];
+    }
+    return sum;
+}
+
+static double numeric(NNConv2D *conv, NNPool2D *pool, const double *input, const double *coefficients, double *value) {
+    double saved = *value;
+    *value = saved + STEP;
+    double up = loss(conv, pool, input, coefficients);
+    *value = saved - STEP;
+    double down = loss(conv, pool, input, coefficients);
+    *value = saved;
+    return (up - down) / (2 * STEP);
+}
+
+static int check(const char *name, double analytic, double expected) {
+    double scale = fabs(expected) > 1 ? fabs(expected) : 1;
+    if (fabs(analytic - expected) / scale > TOLERANCE) {
+        fprintf(stderr, "%s gradient %.9g, numeric %.9g\n", name, analytic, expected);
+        return 1;
+    }
+    return 0;
+}
+
+static int checkPool(NNPoolKind kind, unsigned int size, unsigned int stride) {
+    NNConv2D *conv = NNConv2D_create(CHANNELS, SIZE, SIZE, FILTERS, 3, 1, 1, sigmoid, sigmoid_derivative, 0.1);
+    NNPool2D *pool = conv ? NNPool2D_create(kind, FILTERS, conv->outRows, conv->outCols, size, stride) : NULL;
+    if (!pool) return 1;
+
+    double input[CHANNELS * SIZE * SIZE];
+    double coefficients[FILTERS * SIZE * SIZE];
+    rngUniformBatch(rngThread(), input, CHANNELS * SIZE * SIZE);
+    rngUniformBatch(rngThread(), coefficients, NNPool2D_output_size(pool));
+
+    double before = loss(conv, pool, input, coefficients);
+    NNPool2D_backward(pool, coefficients);
+    NNConv2D_backward(conv, pool->gradInput);
+
+    double gradWeights[FILTERS * CHANNELS * 9];
+    double gradBiases[FILTERS];
+    double gradInput[CHANNELS * SIZE * SIZE];
+    memcpy(gradWeights, conv->gradWeights, sizeof(double) * conv->numWeights);
+    memcpy(gradBiases, conv->gradBiases, sizeof(double) * FILTERS);
+    memcpy(gradInput, conv->gradInput, sizeof(input));
+
+    int failed = 0;
+    for (unsigned int i = 0; i < conv->numWeights; i++) {
+        failed |= check("weight", gradWeights[i], numeric(conv, pool, input, coefficients, &conv->weights[i]));
+    }
+    for (unsigned int i = 0; i < FILTERS; i++) {
+        failed |= check("bias", gradBiases[i], numeric(conv, pool, input, coefficients, &conv->biases[i]));
+    }
+    for (unsigned int i = 0; i < CHANNELS * SIZE * SIZE; i++) {
+        failed |= check("input", gradInput[i], numeric(conv, pool, input, coefficients, &input[i]));
+    }
+
+    NNConv2D_update(conv, 0.1);
+    if (!(loss(conv, pool, input, coefficients) < before)) {
+        fprintf(stderr, "Update did not follow the gradient\n");
+        failed = 1;
+    }
+
+    NNPool2D_destroy(pool);
+    NNConv2D_destroy(conv);
+    return failed;
+}
+
+int main(void) {
+    rngSetSeed(33);
+    int failed = checkPool(NN_POOL_MAX, 2, 2);
+    failed |= checkPool(NN_POOL_AVG, 3, 2);
+    failed |= checkPool(NN_POOL_MAX, 0, 0);
+    return failed;
+}
@@ -0,0 +1,92 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../utils/Evolution/evolution.h"
+
+#define COUNT 37
+#define GENOME 50
+#define STRIDE 56
+
+static double parents[COUNT * STRIDE];
+static double fitness[COUNT];
+
+static int breed(const EvolutionConfig *config, int numWorkers, double *children) {
+    Evolution *evolution = evolutionCreate(COUNT, numWorkers);
+    if (!evolution) return -1;
+    memset(children, 0, sizeof(double) * COUNT * STRIDE);
+    int result = evolutionBreed(evolution, config, parents, children, STRIDE, GENOME, fitness, COUNT, 4242);
+    evolutionDestroy(evolution);
+    return result;
+}
+
+static size_t findParent(const double *child) {
+    for (size_t p = 0; p < COUNT; p++) {
+        if (memcmp(child, parents + p * STRIDE, sizeof(double) * GENOME) == 0) return p;
+    }
+    return SIZE_MAX;
+}
+
+/* The same seed breeds the same children whatever the number of workers. */
+static int checkWorkers(const EvolutionConfig *config, const char *name) {
+    static double serial[COUNT * STRIDE];
+    static double parallel[COUNT * STRIDE];
+    if (breed(config, 1, serial) != 0 || breed(config, 3, parallel) != 0) return 1;
+    if (memcmp(serial, parallel, sizeof(serial)) != 0) {
+        fprintf(stderr, "%s: 1 and 3 workers bred different children\n", name);
+        return 1;
+    }
+    return 0;
+}
+
+/* Without crossover or mutation every child is a copy of a parent, and the elites lead. */
+static int checkSelection(EvolutionConfig config, const char *name) {
+    static double children[COUNT * STRIDE];
+    config.crossoverRate = 0;
+    config.mutationRate = 0;
+    if (breed(&config, 3, children) != 0) return 1;
+
+    int failed = 0;
+    for (size_t c = 0; c < COUNT; c++) {
+        size_t parent = findParent(children + c * STRIDE);
+        if (parent == SIZE_MAX) {
+            fprintf(stderr, "%s: child %zu is not a copy of any parent\n", name, c);
+            return 1;
+        }
+        size_t better = 0;
+        for (size_t p = 0; p < COUNT; p++) better += fitness[p] > fitness[parent];
+        if (c < config.elites && better >= config.elites) {
+            fprintf(stderr, "%s: elite %zu copies parent ranked %zu\n", name, c, better);
+            failed = 1;
+        }
+        if (config.selection == EVOLUTION_TRUNCATION && better >= (size_t)(config.truncation * COUNT)) {
+            fprintf(stderr, "%s: child %zu bred from truncated parent ranked %zu\n", name, c, better);
+            failed = 1;
+        }
+    }
+    return failed;
+}
+
+int main(void) {
+    Rng rng;
+    rngSeed(&rng, 37, 0);
+    rngUniformBatch(&rng, parents, COUNT * STRIDE);
+    rngUniformBatch(&rng, fitness, COUNT);
+
+    EvolutionConfig tournament = {
+        .selection = EVOLUTION_TOURNAMENT,
+        .tournamentSize = 3,
+        .elites = 2,
+        .crossoverRate = 0.3,
+        .mutationRate = 0.5,
+        .mutationStddev = 0.1,
+    };
+    EvolutionConfig truncation = tournament;
+    truncation.selection = EVOLUTION_TRUNCATION;
+    truncation.truncation = 0.25;
+
+    int failed = checkWorkers(&tournament, "tournament");
+    failed |= checkWorkers(&truncation, "truncation");
+    failed |= checkSelection(tournament, "tournament");
+    failed |= checkSelection(truncation, "truncation");
+    return failed;
+}
@@ -0,0 +1,230 @@
+#define main predPreySimMain
+#include "../src/PredPreySim.c"
+#undef main
+
+#define TEST_WORLDS 2
+#define TEST_TICKS 200
+
+typedef struct {
+    NN_t *nn[64];
+    double params[64][VISION_INPUTS * BRAIN_HIDDEN + BRAIN_HIDDEN * NUM_DIRECTIONS + BRAIN_HIDDEN + NUM_DIRECTIONS];
+    double fitness[64];
+    size_t count;
+} Generation;
+
+static void snapshot(const Agents *agents, Generation *generation) {
+    generation->count = agents->count;
+    for (size_t i = 0; i < agents->count; i++) {
+        generation->nn[i] = agents->nn[i];
+        generation->fitness[i] = agents->fitness[i];
+        memcpy(generation->params[i], agents->nn[i]->params, sizeof(generation->params[i]));
+    }
+}
+
+/* Largest per-gene distance from child to its closest parent. */
+static double closestParent(const Generation *parents, const double *child, size_t *closest) {
+    double best = INFINITY;
+    for (size_t p = 0; p < parents->count; p++) {
+        double distance = 0;
+        for (size_t g = 0; g < sizeof(parents->params[p]) / sizeof(double); g++) {
+            double d = fabs(child[g] - parents->params[p][g]);
+            if (d > distance) distance = d;
+        }
+        if (distance < best) {
+            best = distance;
+            *closest = p;
+        }
+    }
+    return best;
+}
+
+/*
+ * Children keep their agents' networks and must each descend from one
+ * parent of the finished generation: exactly without mutation, within the
+ * Irwin-Hall noise bound with it. The elite slot holds the fittest parent.
+ */
+static int checkInheritance(Simulation *simulation, Canvas *canvas, const char *name, double bound) {
+    static Generation parents[2];
+    Agents *species[2] = {&simulation->predators, &simulation->preys};
+    for (int t = 0; t < TEST_TICKS; t++) {
+        updateSimulation(simulation, canvas);
+    }
+    for (int s = 0; s < 2; s++) {
+        snapshot(species[s], &parents[s]);
+    }
+    restartSimulation(simulation, canvas);
+
+    int failed = 0;
+    for (int s = 0; s < 2; s++) {
+        Agents *agents = species[s];
+        for (size_t i = 0; i < agents->count; i++) {
+            size_t parent = SIZE_MAX;
+            double distance = closestParent(&parents[s], agents->nn[i]->params, &parent);
+            if (agents->nn[i] != parents[s].nn[i]) {
+                fprintf(stderr, "%s: agent %zu was given a new network\n", name, i);
+                failed = 1;
+            }
+            if (distance > bound) {
+                fprintf(stderr, "%s: agent %zu is %g from every parent\n", name, i, distance);
+                failed = 1;
+            }
+            if (agents->health[i] != (unsigned int)params.initialHealth || agents->timeAlive[i] != 0) {
+                fprintf(stderr, "%s: agent %zu was not reset\n", name, i);
+                failed = 1;
+            }
+        }
+        double best = parents[s].fitness[0];
+        for (size_t p = 1; p < parents[s].count; p++) {
+            if (parents[s].fitness[p] > best) best = parents[s].fitness[p];
+        }
+        int elite = 0;
+        for (size_t p = 0; p < parents[s].count; p++) {
+            elite |= parents[s].fitness[p] == best &&
+                     memcmp(agents->nn[0]->params, parents[s].params[p], sizeof(parents[s].params[p])) == 0;
+        }
+        if (!elite) {
+            fprintf(stderr, "%s: the elite slot lost the fittest parent\n", name);
+            failed = 1;
+        }
+    }
+    return failed;
+}
+
+static uint64_t hashSimulation(const Simulation *simulation) {
+    uint64_t hash = NN_model_checksum(&simulation->tick, sizeof(simulation->tick));
+    const Agents *species[2] = {&simulation->predators, &simulation->preys};
+    for (int s = 0; s < 2; s++) {
+        for (size_t i = 0; i < species[s]->count; i++) {
+            hash = hash * 31 + NN_model_checksum(species[s]->nn[i]->params, sizeof(double) * species[s]->nn[i]->numParams);
+            hash = hash * 31 + species[s]->x[i] + 256u * species[s]->y[i] + 65536u * species[s]->health[i];
+        }
+    }
+    return hash;
+}
+
+static uint64_t runGenerations(Canvas *canvas, int numThreads) {
+    rngSetSeed(37);
+    Simulation *simulation = createSimulation(canvas, TEST_WORLDS, numThreads);
+    if (!simulation) return 0;
+    for (int generation = 0; generation < 3; generation++) {
+        for (int t = 0; t < TEST_TICKS; t++) {
+            updateSimulation(simulation, canvas);
+        }
+        restartSimulation(simulation, canvas);
+    }
+    uint64_t hash = hashSimulation(simulation);
+    destroySimulation(simulation);
+    return hash;
+}
+
+/* Agents of agents carrying genome as narrowed to float32 for migration. */
+static size_t countCarriers(const Agents *agents, const double *genome, size_t numParams) {
+    size_t carriers = 0;
+    for (size_t i = 0; i < agents->count; i++) {
+        size_t g = 0;
+        while (g < numParams && agents->nn[i]->params[g] == (double)(float)genome[g]) g++;
+        carriers += g == numParams;
+    }
+    return carriers;
+}
+
+/*
+ * Island 0's fittest predator migrates to island 1 at island 0's turnover.
+ * With every slot elite and no mutation, the migrant must show up in island
+ * 1's next generation and stay through the generation after.
+ */
+static int checkMigration(Canvas *canvas) {
+    IslandOptions home = {0, 2, "."};
+    IslandOptions away = {1, 2, "."};
+    Simulation *source = createSimulation(canvas, 1, 1);
+    Simulation *target = createSimulation(canvas, 1, 1);
+    if (!source || !target || !attachIslands(source, &home) || !attachIslands(target, &away)) return 1;
+    for (int t = 0; t < TEST_TICKS; t++) {
+        updateSimulation(source, canvas);
+    }
+
+    Agents *predators = &source->predators;
+    size_t numParams = predators->nn[0]->numParams;
+    double *migrant = malloc(sizeof(double) * numParams);
+    if (!migrant) return 1;
+    memcpy(migrant, predators->nn[fittestAgent(predators)]->params, sizeof(double) * numParams);
+    restartSimulation(source, canvas);
+
+    size_t carriers = 0;
+    double *returned = malloc(sizeof(double) * numParams);
+    double fitness;
+    if (!returned) return 1;
+    for (int attempt = 0; attempt < 100 && carriers == 0; attempt++) {
+        islandImmigrate(source->predatorIsland, returned, &fitness); /* flushes what the socket did not take yet */
+        restartSimulation(target, canvas);
+        carriers = countCarriers(&target->predators, migrant, numParams);
+    }
+    restartSimulation(target, canvas);
+    int failed = 0;
+    if (carriers == 0 || countCarriers(&target->predators, migrant, numParams) == 0) {
+        fprintf(stderr, "The migrant did not survive the turnover on its new island\n");
+        failed = 1;
+    }
+
+    free(returned);
+    free(migrant);
+    destroySimulation(source);
+    destroySimulation(target);
+    return failed;
+}
+
+/* A prey caught by more predators than its health can pay for must die at 0, not wrap round to the fittest. */
+static int checkDrain(Canvas *canvas) {
+    Simulation *simulation = createSimulation(canvas, 1, 1);
+    if (!simulation) return 1;
+    Agents *predators = &simulation->predators;
+    Agents *preys = &simulation->preys;
+    for (size_t i = 0; i < predators->count; i++) {
+        predators->x[i] = preys->x[0];
+        predators->y[i] = preys->y[0];
+    }
+    preys->health[0] = 1;
+    learnAgent(preys, 0, canvas, simulation);
+
+    int failed = 0;
+    if (preys->health[0] != 0 || preys->fitness[0] > 1 + (double)preys->timeAlive[0]) {
+        fprintf(stderr, "A drained prey kept health %u and fitness %g\n", preys->health[0], preys->fitness[0]);
+        failed = 1;
+    }
+    destroySimulation(simulation);
+    return failed;
+}
+
+int main(void) {
+    Canvas *canvas = initCanvas(25, 40, ' ');
+    if (!canvas) return 1;
+
+    SimulationParams defaults = params;
+    setParam("mutation_rate=0");
+    setParam("crossover_rate=0");
+    rngSetSeed(11);
+    Simulation *simulation = createSimulation(canvas, TEST_WORLDS, 1);
+    if (!simulation) return 1;
+    int failed = checkInheritance(simulation, canvas, "selection", 0);
+
+    params.mutationRate = defaults.mutationRate;
+    failed |= checkInheritance(simulation, canvas, "mutation", 2 * sqrt(3) * params.mutationStddev + 1e-12);
+    destroySimulation(simulation);
+
+    setParam("mutation_rate=0");
+    setParam("elites=1000");
+    failed |= checkMigration(canvas);
+    params = defaults;
+
+    setParam("catch_radius=1");
+    failed |= checkDrain(canvas);
+    params = defaults;
+
+    if (runGenerations(canvas, 1) != runGenerations(canvas, 3)) {
+        fprintf(stderr, "1 and 3 workers evolved different generations\n");
+        failed = 1;
+    }
+
+    freeCanvas(canvas);
+    return failed;
+}
@@ -0,0 +1,59 @@
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "../utils/NNS/NN_model.h"
+#include "../utils/NNS/NN_population.h"
+#include "../utils/Random/rng.h"
+
+#define MODEL_PATH "test_model.nn"
+
+int main(void) {
+    ActivationFunction hidden[6], hiddenDerivatives[6], output[3], outputDerivatives[3];
+    for (int i = 0; i < 6; i++) {
+        hidden[i] = sigmoid;
+        hiddenDerivatives[i] = sigmoid_derivative;
+    }
+    for (int i = 0; i < 3; i++) {
+        output[i] = linear;
+        outputDerivatives[i] = linear_derivative;
+    }
+    rngSetSeed(7);
+    NN_t *saved = NN_create(4, 6, 3, hidden, hiddenDerivatives, output, outputDerivatives, 0.1, 0.5);
+    NN_t *peer = NN_create(4, 6, 3, hidden, hiddenDerivatives, output, outputDerivatives, 0.1, 0.5);
+    if (!saved || !peer) return 1;
+    NN_set_loss(saved, NN_LOSS_SOFTMAX_CROSS_ENTROPY);
+    NN_set_loss(peer, NN_LOSS_SOFTMAX_CROSS_ENTROPY);
+    if (NN_save(saved, MODEL_PATH) != 0) return 1;
+
+    int failed = 0;
+    if (NN_model_checksum("a", 1) != 0xaf63dc4c8601ec8cULL || NN_model_checksum("foobar", 6) != 0x85944171f73967e8ULL) {
+        fprintf(stderr, "Model checksum is not FNV-1a\n");
+        failed = 1;
+    }
+    NN_t *loaded = NN_load(MODEL_PATH, 1);
+    unlink(MODEL_PATH);
+    if (!loaded) return 1;
+    if (loaded->loss != NN_LOSS_SOFTMAX_CROSS_ENTROPY) {
+        fprintf(stderr, "Loaded network lost its softmax cross-entropy loss\n");
+        failed = 1;
+    }
+    if (loaded->ownsParams || memcmp(loaded->params, saved->params, sizeof(double) * saved->numParams) != 0) {
+        fprintf(stderr, "Loaded network does not map the saved params\n");
+        failed = 1;
+    }
+
+    NN_t *networks[2] = {peer, loaded};
+    NNPopulation *population = NNPopulation_create(networks, 2);
+    if (!population) return 1;
+    loaded->params[0] += 1.0;
+    NNPopulation_destroy(population);
+    if (!loaded->ownsParams || loaded->params[0] != saved->params[0] + 1.0) {
+        fprintf(stderr, "Loaded network did not keep its population copy\n");
+        failed = 1;
+    }
+
+    NN_destroy(loaded);
+    NN_destroy(peer);
+    NN_destroy(saved);
+    return failed;
+}
@@ -0,0 +1,129 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../utils/NNS/NN_parallel.h"
+#include "../utils/Random/rng.h"
+
+#define EPOCHS 20
+
+static NN_t *createNetwork(uint64_t seed) {
+    ActivationFunction hidden[8], hiddenDerivatives[8], output[1], outputDerivatives[1];
+    for (int i = 0; i < 8; i++) {
+        hidden[i] = sigmoid;
+        hiddenDerivatives[i] = sigmoid_derivative;
+    }
+    output[0] = sigmoid;
+    outputDerivatives[0] = sigmoid_derivative;
+    rngSetSeed(seed);
+    return NN_create(2, 8, 1, hidden, hiddenDerivatives, output, outputDerivatives, 0.5, 0.5);
+}
+
+static double maxDelta(const NN_t *a, const NN_t *b) {
+    double delta = 0;
+    for (unsigned int i = 0; i < a->numParams; i++) {
+        double d = fabs(a->params[i] - b->params[i]);
+        if (d > delta) delta = d;
+    }
+    return delta;
+}
+
+/* The reported softmax cross-entropy must be the mean per-sample loss, as serial backprop reports it. */
+static int checkCrossEntropyLoss(void) {
+    ActivationFunction hidden[6], hiddenDerivatives[6], output[3], outputDerivatives[3];
+    for (int i = 0; i < 6; i++) {
+        hidden[i] = sigmoid;
+        hiddenDerivatives[i] = sigmoid_derivative;
+    }
+    for (int i = 0; i < 3; i++) {
+        output[i] = linear;
+        outputDerivatives[i] = linear_derivative;
+    }
+    double inputs[8] = {0, 0, 0, 1, 1, 0, 1, 1};
+    double targets[12] = {1, 0, 0, 0, 1, 0, 0, 1, 0, 0, 0, 1};
+    NN_t *networks[2];
+    for (int n = 0; n < 2; n++) {
+        rngSetSeed(2);
+        networks[n] = NN_create(2, 6, 3, hidden, hiddenDerivatives, output, outputDerivatives, 0.1, 0.5);
+        if (!networks[n]) return 1;
+        NN_set_loss(networks[n], NN_LOSS_SOFTMAX_CROSS_ENTROPY);
+    }
+
+    double expected = 0;
+    for (int i = 0; i < 4; i++) {
+        forward(networks[0], inputs + 2 * i);
+        backprop(networks[0], targets + 3 * i);
+        expected += networks[0]->error / 4;
+    }
+    NNParallelTrainer *trainer = NNParallel_create(networks[1], 1, NN_PARALLEL_ALLREDUCE);
+    double error = trainer ? NNParallel_train(trainer, inputs, targets, 4, 1, 1) : -1.0;
+    NNParallel_destroy(trainer);
+
+    int failed = 0;
+    if (fabs(error - expected) > 1e-12) {
+        fprintf(stderr, "Parallel cross-entropy %g is not the serial mean %g\n", error, expected);
+        failed = 1;
+    }
+    NN_destroy(networks[0]);
+    NN_destroy(networks[1]);
+    return failed;
+}
+
+int main(void) {
+    double inputs[8] = {0, 0, 0, 1, 1, 0, 1, 1};
+    double targets[4] = {0, 1, 1, 0};
+    int failed = 0;
+
+    NN_t *serial = createNetwork(1);
+    NN_t *parallel = createNetwork(1);
+    NN_t *sharded = createNetwork(1);
+    NN_t *wild = createNetwork(1);
+    if (!serial || !parallel || !sharded || !wild) return 1;
+
+    for (int epoch = 0; epoch < EPOCHS; epoch++) {
+        for (int i = 0; i < 4; i++) {
+            forward(serial, inputs + 2 * i);
+            backprop(serial, targets + i);
+        }
+    }
+    NNParallelTrainer *trainer = NNParallel_create(parallel, 1, NN_PARALLEL_ALLREDUCE);
+    NNParallel_train(trainer, inputs, targets, 4, 1, EPOCHS);
+    NNParallel_destroy(trainer);
+    if (memcmp(serial->params, parallel->params, sizeof(double) * serial->numParams) != 0) {
+        fprintf(stderr, "One all-reduce worker diverged from backprop: max |delta| = %g\n", maxDelta(serial, parallel));
+        failed = 1;
+    }
+
+    NN_t *batched = createNetwork(1);
+    trainer = NNParallel_create(batched, 1, NN_PARALLEL_ALLREDUCE);
+    NNParallel_train(trainer, inputs, targets, 4, 4, EPOCHS);
+    NNParallel_destroy(trainer);
+    trainer = NNParallel_create(sharded, 3, NN_PARALLEL_ALLREDUCE);
+    NNParallel_train(trainer, inputs, targets, 4, 4, EPOCHS);
+    NNParallel_destroy(trainer);
+    if (maxDelta(batched, sharded) > 1e-12) {
+        fprintf(stderr, "Three all-reduce workers diverged from one: max |delta| = %g\n", maxDelta(batched, sharded));
+        failed = 1;
+    }
+
+    if (NNParallel_create(wild, 2, NN_PARALLEL_HOGWILD)) {
+        fprintf(stderr, "Hogwild accepted a momentum optimizer\n");
+        failed = 1;
+    }
+    NN_set_optimizer(wild, NN_SGD);
+    trainer = NNParallel_create(wild, 2, NN_PARALLEL_HOGWILD);
+    double error = trainer ? NNParallel_train(trainer, inputs, targets, 4, 0, EPOCHS) : -1.0;
+    NNParallel_destroy(trainer);
+    if (!(error >= 0)) {
+        fprintf(stderr, "Hogwild SGD failed to train\n");
+        failed = 1;
+    }
+
+    failed |= checkCrossEntropyLoss();
+
+    NN_destroy(serial);
+    NN_destroy(parallel);
+    NN_destroy(batched);
+    NN_destroy(sharded);
+    NN_destroy(wild);
+    return failed;
+}
@@ -0,0 +1,109 @@
+#include <stdio.h>
+#include <string.h>
+#include "../utils/NNS/NN_population.h"
+#include "../utils/Random/rng.h"
+
+#define NUM_INPUTS 5
+#define NUM_HIDDEN 7
+#define NUM_OUTPUT 3
+#define MAX_NETWORKS 40
+
+static ActivationFunction hidden[NUM_HIDDEN], hiddenDerivatives[NUM_HIDDEN];
+static ActivationFunction output[NUM_OUTPUT], outputDerivatives[NUM_OUTPUT];
+
+static NN_t *createNetwork(void) {
+    return NN_create(NUM_INPUTS, NUM_HIDDEN, NUM_OUTPUT, hidden, hiddenDerivatives, output, outputDerivatives, 0.1, 0.5);
+}
+
+/* Every member must sit in its own slot, carry its first param as a tag and match its lone forward pass. */
+static int checkBound(NNPopulation *pop, NN_t **networks, const double *tags, unsigned int count) {
+    if (pop->numNetworks != count) {
+        fprintf(stderr, "Population has %u members, expected %u\n", pop->numNetworks, count);
+        return 1;
+    }
+
+    double inputs[MAX_NETWORKS * NUM_INPUTS];
+    Rng *rng = rngThread();
+    rngUniformBatch(rng, inputs, (size_t)count * NUM_INPUTS);
+    NNPopulation_forward(pop, inputs, NUM_INPUTS);
+
+    for (unsigned int i = 0; i < count; i++) {
+        NN_t *nn = networks[i];
+        if (pop->networks[i] != nn || nn->params != pop->params + i * pop->paramStride || nn->params[0] != tags[i]) {
+            fprintf(stderr, "Member %u is not bound to its slot\n", i);
+            return 1;
+        }
+        double batched[NUM_OUTPUT];
+        memcpy(batched, nn->output, sizeof(batched));
+        forward(nn, inputs + (size_t)i * NUM_INPUTS);
+        if (memcmp(batched, nn->output, sizeof(batched)) != 0) {
+            fprintf(stderr, "Member %u's batched forward differs from its own\n", i);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int main(void) {
+    for (int i = 0; i < NUM_HIDDEN; i++) {
+        hidden[i] = sigmoid;
+        hiddenDerivatives[i] = sigmoid_derivative;
+    }
+    for (int i = 0; i < NUM_OUTPUT; i++) {
+        output[i] = linear;
+        outputDerivatives[i] = linear_derivative;
+    }
+    rngSetSeed(11);
+
+    NN_t *networks[MAX_NETWORKS];
+    double tags[MAX_NETWORKS];
+    unsigned int count = 0;
+    for (; count < 2; count++) {
+        networks[count] = createNetwork();
+        if (!networks[count]) return 1;
+        tags[count] = networks[count]->params[0] = (double)count;
+    }
+    NNPopulation *pop = NNPopulation_create(networks, count);
+    if (!pop) return 1;
+
+    int failed = 0;
+    unsigned int next = count;
+    for (int round = 0; round < 200 && !failed; round++) {
+        Rng *rng = rngThread();
+        if (count < MAX_NETWORKS && (count < 2 || rngBelow(rng, 3) != 0)) {
+            NN_t *nn = createNetwork();
+            if (!nn) return 1;
+            nn->params[0] = (double)next;
+            if (NNPopulation_add(pop, nn) != 0) return 1;
+            networks[count] = nn;
+            tags[count++] = (double)next++;
+        } else {
+            unsigned int i = rngBelow(rng, count);
+            NN_t *gone = networks[i];
+            NNPopulation_remove(pop, i);
+            if (!gone->ownsParams || gone->params[0] != tags[i]) {
+                fprintf(stderr, "Removed member did not get its params back\n");
+                failed = 1;
+            }
+            NN_destroy(gone);
+            count--;
+            networks[i] = networks[count];
+            tags[i] = tags[count];
+        }
+        failed |= checkBound(pop, networks, tags, count);
+    }
+
+    NN_t *wrong = NN_create(NUM_INPUTS + 1, NUM_HIDDEN, NUM_OUTPUT, hidden, hiddenDerivatives, output, outputDerivatives, 0.1, 0.5);
+    if (!wrong) return 1;
+    if (NNPopulation_add(pop, wrong) == 0) {
+        fprintf(stderr, "Population accepted a network of another shape\n");
+        failed = 1;
+    }
+    NN_destroy(wrong);
+
+    NNPopulation_destroy(pop);
+    for (unsigned int i = 0; i < count; i++) {
+        NN_destroy(networks[i]);
+    }
+    return failed;
+}
@@ -0,0 +1,78 @@
+#include <math.h>
+#include <stdio.h>
+#include "../utils/NNS/NN.h"
+#include "../utils/Random/rng.h"
+
+#define NUM_INPUTS 5
+#define NUM_HIDDEN 8
+#define NUM_OUTPUT 3
+#define NUM_SAMPLES 256
+#define TOLERANCE 1e-4
+
+/*
+ * NN_t and NN32_t must compute the same function for every activation kind,
+ * so switching precision only changes rounding: the float network, given
+ * the double network's params, has to land within TOLERANCE of it.
+ */
+int main(void) {
+    ActivationFunction hidden[NUM_HIDDEN], hiddenDerivatives[NUM_HIDDEN], output[NUM_OUTPUT], outputDerivatives[NUM_OUTPUT];
+    ActivationFunction32 hidden32[NUM_HIDDEN], hiddenDerivatives32[NUM_HIDDEN], output32[NUM_OUTPUT], outputDerivatives32[NUM_OUTPUT];
+    ActivationFunction kinds[3] = {sigmoid, relu, tanh_activation};
+    ActivationFunction derivatives[3] = {sigmoid_derivative, relu_derivative, tanh_derivative};
+    ActivationFunction32 kinds32[3] = {sigmoid32, relu32, tanh_activation32};
+    ActivationFunction32 derivatives32[3] = {sigmoid_derivative32, relu_derivative32, tanh_derivative32};
+    for (int i = 0; i < NUM_HIDDEN; i++) {
+        hidden[i] = kinds[i % 3];
+        hiddenDerivatives[i] = derivatives[i % 3];
+        hidden32[i] = kinds32[i % 3];
+        hiddenDerivatives32[i] = derivatives32[i % 3];
+    }
+    for (int i = 0; i < NUM_OUTPUT; i++) {
+        output[i] = kinds[(i + 2) % 3];
+        outputDerivatives[i] = derivatives[(i + 2) % 3];
+        output32[i] = kinds32[(i + 2) % 3];
+        outputDerivatives32[i] = derivatives32[(i + 2) % 3];
+    }
+
+    int failed = 0;
+    for (double x = -20; x <= 20; x += 0.25) {
+        if (tanh_activation(x) != tanh(x) || fabsf(tanh_activation32((float)x) - (float)tanh(x)) > 1e-6f) {
+            fprintf(stderr, "tanh activation strays from tanh at %g\n", x);
+            failed = 1;
+            break;
+        }
+    }
+
+    rngSetSeed(3);
+    NN_t *nn = NN_create(NUM_INPUTS, NUM_HIDDEN, NUM_OUTPUT, hidden, hiddenDerivatives, output, outputDerivatives, 0.1, 0.5);
+    NN32_t *nn32 = NN32_create(NUM_INPUTS, NUM_HIDDEN, NUM_OUTPUT, hidden32, hiddenDerivatives32, output32, outputDerivatives32, 0.1f, 0.5f);
+    if (!nn || !nn32) return 1;
+    for (unsigned int i = 0; i < nn->numParams; i++) {
+        nn32->params[i] = (float)nn->params[i];
+    }
+
+    Rng *rng = rngThread();
+    double worst = 0;
+    for (int s = 0; s < NUM_SAMPLES; s++) {
+        double input[NUM_INPUTS], hiddenOut[NUM_HIDDEN], out[NUM_OUTPUT];
+        float input32[NUM_INPUTS], hiddenOut32[NUM_HIDDEN], out32[NUM_OUTPUT];
+        for (int i = 0; i < NUM_INPUTS; i++) {
+            input32[i] = (float)(rngUniform(rng) * 8 - 4);
+            input[i] = input32[i];
+        }
+        NN_infer(nn, input, hiddenOut, out);
+        NN32_infer(nn32, input32, hiddenOut32, out32);
+        for (int i = 0; i < NUM_OUTPUT; i++) {
+            double delta = fabs(out[i] - out32[i]);
+            if (delta > worst || isnan(delta)) worst = delta;
+        }
+    }
+    if (!(worst <= TOLERANCE)) {
+        fprintf(stderr, "Float and double networks differ by %g\n", worst);
+        failed = 1;
+    }
+
+    NN32_destroy(nn32);
+    NN_destroy(nn);
+    return failed;
+}
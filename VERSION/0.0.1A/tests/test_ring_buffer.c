@@ -0,0 +1,121 @@
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../utils/Concurrency/ring_buffer.h"
+
+#define NUM_PRODUCERS 4
+#define NUM_CONSUMERS 4
+#define RECORDS_PER_PRODUCER 100000
+
+typedef struct {
+    unsigned int producer;
+    unsigned int index;
+    double payload;
+} Record;
+
+static RingBuffer *ring;
+static _Atomic unsigned char seen[NUM_PRODUCERS][RECORDS_PER_PRODUCER];
+static atomic_size_t popped;
+static atomic_int failed;
+
+static void *produce(void *arg) {
+    unsigned int producer = (unsigned int)(size_t)arg;
+    for (unsigned int i = 0; i < RECORDS_PER_PRODUCER; i++) {
+        Record record = {producer, i, producer * 0.5 + i};
+        while (ringBufferPush(ring, &record) != 0) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+/* Each consumer must see every producer's records in the order they were pushed. */
+static void *consume(void *arg) {
+    (void)arg;
+    int last[NUM_PRODUCERS];
+    for (int p = 0; p < NUM_PRODUCERS; p++) last[p] = -1;
+
+    while (atomic_load(&popped) < (size_t)NUM_PRODUCERS * RECORDS_PER_PRODUCER) {
+        Record record;
+        if (!ringBufferPop(ring, &record)) {
+            sched_yield();
+            continue;
+        }
+        atomic_fetch_add(&popped, 1);
+        if (record.producer >= NUM_PRODUCERS || record.index >= RECORDS_PER_PRODUCER ||
+            record.payload != record.producer * 0.5 + record.index || (int)record.index <= last[record.producer] ||
+            atomic_fetch_add(&seen[record.producer][record.index], 1) != 0) {
+            atomic_store(&failed, 1);
+            continue;
+        }
+        last[record.producer] = (int)record.index;
+    }
+    return NULL;
+}
+
+static int checkSequential(void) {
+    RingBuffer *small = ringBufferCreate(5, sizeof(int));
+    if (!small || small->capacity != 8) {
+        fprintf(stderr, "Ring buffer capacity was not rounded up to a power of two\n");
+        ringBufferDestroy(small);
+        return 1;
+    }
+
+    int value;
+    int bad = ringBufferPop(small, &value) != 0;
+    /* Several laps so the slot sequence numbers wrap around the array. */
+    for (int lap = 0; lap < 5 && !bad; lap++) {
+        for (int i = 0; i < 8; i++) {
+            value = lap * 8 + i;
+            bad |= ringBufferPush(small, &value) != 0;
+        }
+        value = -1;
+        bad |= ringBufferPush(small, &value) != -1;
+        for (int i = 0; i < 8; i++) {
+            bad |= ringBufferPop(small, &value) != 1 || value != lap * 8 + i;
+        }
+        bad |= ringBufferPop(small, &value) != 0;
+    }
+    if (bad) {
+        fprintf(stderr, "Ring buffer is not a bounded FIFO\n");
+    }
+    ringBufferDestroy(small);
+    return bad;
+}
+
+int main(void) {
+    if (checkSequential()) return 1;
+    if (ringBufferCreate(1, sizeof(int)) || ringBufferCreate(8, 0)) {
+        fprintf(stderr, "Ring buffer accepted a degenerate shape\n");
+        return 1;
+    }
+
+    ring = ringBufferCreate(64, sizeof(Record));
+    if (!ring) return 1;
+
+    pthread_t producers[NUM_PRODUCERS], consumers[NUM_CONSUMERS];
+    for (size_t i = 0; i < NUM_CONSUMERS; i++) {
+        pthread_create(&consumers[i], NULL, consume, NULL);
+    }
+    for (size_t i = 0; i < NUM_PRODUCERS; i++) {
+        pthread_create(&producers[i], NULL, produce, (void *)i);
+    }
+    for (size_t i = 0; i < NUM_PRODUCERS; i++) {
+        pthread_join(producers[i], NULL);
+    }
+    for (size_t i = 0; i < NUM_CONSUMERS; i++) {
+        pthread_join(consumers[i], NULL);
+    }
+
+    Record extra;
+    if (atomic_load(&failed) || atomic_load(&popped) != (size_t)NUM_PRODUCERS * RECORDS_PER_PRODUCER ||
+        ringBufferPop(ring, &extra)) {
+        fprintf(stderr, "Concurrent producers and consumers lost, duplicated or reordered records\n");
+        ringBufferDestroy(ring);
+        return 1;
+    }
+    ringBufferDestroy(ring);
+    return 0;
+}
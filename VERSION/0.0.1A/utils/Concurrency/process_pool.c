@@ -0,0 +1,159 @@
+#include <errno.h>
+#include <limits.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "process_pool.h"
+
+typedef struct {
+    uint64_t job;
+    int64_t status;
+} ProcessRecord;
+
+static int readFully(int fd, void *data, size_t size) {
+    unsigned char *bytes = (unsigned char *)data;
+    size_t done = 0;
+    while (done < size) {
+        ssize_t n = read(fd, bytes + done, size - done);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return 0;
+        done += (size_t)n;
+    }
+    return 1;
+}
+
+static void workerLoop(int jobs, int results, size_t resultSize, ProcessJob run, void *context) {
+    size_t recordSize = sizeof(ProcessRecord) + resultSize;
+    unsigned char *record = (unsigned char *)malloc(recordSize);
+    if (!record) return;
+    uint64_t job;
+    while (readFully(jobs, &job, sizeof(job))) {
+        ProcessRecord header = {job, 0};
+        memset(record + sizeof(ProcessRecord), 0, resultSize);
+        header.status = run((size_t)job, record + sizeof(ProcessRecord), context);
+        memcpy(record, &header, sizeof(header));
+        if (write(results, record, recordSize) != (ssize_t)recordSize) break;
+    }
+    free(record);
+}
+
+int processPoolRun(size_t numJobs, int numWorkers, size_t resultSize,
+                   ProcessJob run, ProcessCollect collect, void *context) {
+    size_t recordSize = sizeof(ProcessRecord) + resultSize;
+    if (recordSize > PIPE_BUF) {
+        fprintf(stderr, "Process pool results of %zu bytes exceed PIPE_BUF\n", resultSize);
+        return -1;
+    }
+    if (numJobs == 0) return 0;
+    if (numWorkers <= 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        numWorkers = online > 0 ? (int)online : 1;
+    }
+    if ((size_t)numWorkers > numJobs) numWorkers = (int)numJobs;
+
+    int jobs[2];
+    int results[2];
+    unsigned char *reported = (unsigned char *)calloc(numJobs, 1);
+    unsigned char *record = (unsigned char *)malloc(recordSize);
+    pid_t *workers = (pid_t *)calloc((size_t)numWorkers, sizeof(pid_t));
+    if (!reported || !record || !workers || pipe(jobs) != 0) {
+        fprintf(stderr, "Failed to set up process pool\n");
+        free(reported);
+        free(record);
+        free(workers);
+        return -1;
+    }
+    if (pipe(results) != 0) {
+        perror("Failed to set up process pool");
+        close(jobs[0]);
+        close(jobs[1]);
+        free(reported);
+        free(record);
+        free(workers);
+        return -1;
+    }
+    void (*previousPipe)(int) = signal(SIGPIPE, SIG_IGN);
+    fflush(NULL);
+
+    int started = 0;
+    for (int w = 0; w < numWorkers; w++) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            close(jobs[1]);
+            close(results[0]);
+            workerLoop(jobs[0], results[1], resultSize, run, context);
+            _exit(0);
+        }
+        if (pid < 0) {
+            perror("Failed to fork pool worker");
+            continue;
+        }
+        workers[w] = pid;
+        started++;
+    }
+    close(jobs[0]);
+    close(results[1]);
+
+    size_t next = 0;
+    size_t received = 0;
+    int failed = 0;
+    int jobsOpen = 1;
+    if (started == 0) {
+        close(jobs[1]);
+        jobsOpen = 0;
+    }
+    while (started > 0 && received < numJobs) {
+        struct pollfd fds[2] = {{results[0], POLLIN, 0}, {jobs[1], POLLOUT, 0}};
+        nfds_t count = jobsOpen ? 2 : 1;
+        if (poll(fds, count, -1) < 0) {
+            if (errno == EINTR) continue;
+            perror("Process pool poll failed");
+            break;
+        }
+        if (jobsOpen && (fds[1].revents & (POLLOUT | POLLERR | POLLHUP))) {
+            uint64_t job = next;
+            if ((fds[1].revents & POLLOUT) && write(jobs[1], &job, sizeof(job)) == (ssize_t)sizeof(job)) {
+                next++;
+            } else if (!(fds[1].revents & POLLOUT)) {
+                next = numJobs;
+            }
+            if (next == numJobs) {
+                close(jobs[1]);
+                jobsOpen = 0;
+            }
+        }
+        if (fds[0].revents & (POLLIN | POLLHUP)) {
+            if (!readFully(results[0], record, recordSize)) break;
+            ProcessRecord header;
+            memcpy(&header, record, sizeof(header));
+            if (header.job < numJobs && !reported[header.job]) {
+                reported[header.job] = 1;
+                received++;
+                failed += header.status != 0;
+                collect((size_t)header.job, (int)header.status, record + sizeof(ProcessRecord), context);
+            }
+        }
+    }
+    if (jobsOpen) close(jobs[1]);
+    close(results[0]);
+    for (int w = 0; w < numWorkers; w++) {
+        if (workers[w] > 0) waitpid(workers[w], NULL, 0);
+    }
+    signal(SIGPIPE, previousPipe);
+
+    for (size_t job = 0; job < numJobs; job++) {
+        if (!reported[job]) {
+            collect(job, -1, NULL, context);
+            failed++;
+        }
+    }
+    free(reported);
+    free(record);
+    free(workers);
+    return failed;
+}
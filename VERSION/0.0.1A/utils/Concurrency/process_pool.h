@@ -0,0 +1,22 @@
+#ifndef PROCESS_POOL_H
+#define PROCESS_POOL_H
+
+#include <stddef.h>
+
+/* Runs in a worker process; fills result (zeroed, resultSize bytes) and returns 0 on success. */
+typedef int (*ProcessJob)(size_t job, void *result, void *context);
+/* Runs in the calling process as results arrive; result is NULL when the job's worker died. */
+typedef void (*ProcessCollect)(size_t job, int status, const void *result, void *context);
+
+/*
+ * Forks numWorkers processes that pull job indices 0..numJobs-1 from one
+ * shared pipe and send fixed-size results back through another, so
+ * workers stay busy until the queue is empty however uneven the jobs are.
+ * A result must fit in one atomic pipe write (PIPE_BUF bytes, header
+ * included). Call before starting any threads. Returns the number of jobs
+ * that failed or never reported, or -1 if the pool could not start.
+ */
+int processPoolRun(size_t numJobs, int numWorkers, size_t resultSize,
+                   ProcessJob run, ProcessCollect collect, void *context);
+
+#endif
@@ -0,0 +1,78 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ring_buffer.h"
+
+RingBuffer *ringBufferCreate(size_t capacity, size_t recordSize) {
+    if (capacity < 2 || recordSize == 0) return NULL;
+    size_t rounded = 2;
+    while (rounded < capacity) rounded <<= 1;
+
+    RingBuffer *ring = (RingBuffer *)calloc(1, sizeof(RingBuffer));
+    if (!ring) return NULL;
+
+    ring->capacity = rounded;
+    ring->recordSize = recordSize;
+    ring->sequences = (_Atomic size_t *)malloc(sizeof(*ring->sequences) * rounded);
+    ring->records = (unsigned char *)malloc(recordSize * rounded);
+    if (!ring->sequences || !ring->records) {
+        fprintf(stderr, "Failed to allocate ring buffer of %zu records\n", rounded);
+        ringBufferDestroy(ring);
+        return NULL;
+    }
+
+    for (size_t i = 0; i < rounded; i++) {
+        atomic_init(&ring->sequences[i], i);
+    }
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+    return ring;
+}
+
+void ringBufferDestroy(RingBuffer *ring) {
+    if (!ring) return;
+    free((void *)ring->sequences);
+    free(ring->records);
+    free(ring);
+}
+
+/* Returns 0, or -1 when the queue is full. */
+int ringBufferPush(RingBuffer *ring, const void *record) {
+    size_t mask = ring->capacity - 1;
+    size_t pos = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    for (;;) {
+        size_t sequence = atomic_load_explicit(&ring->sequences[pos & mask], memory_order_acquire);
+        intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&ring->head, &pos, pos + 1, memory_order_relaxed, memory_order_relaxed)) break;
+        } else if (diff < 0) {
+            return -1;
+        } else {
+            pos = atomic_load_explicit(&ring->head, memory_order_relaxed);
+        }
+    }
+    memcpy(ring->records + (pos & mask) * ring->recordSize, record, ring->recordSize);
+    atomic_store_explicit(&ring->sequences[pos & mask], pos + 1, memory_order_release);
+    return 0;
+}
+
+/* Returns 1 and fills record, or 0 when the queue is empty. */
+int ringBufferPop(RingBuffer *ring, void *record) {
+    size_t mask = ring->capacity - 1;
+    size_t pos = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    for (;;) {
+        size_t sequence = atomic_load_explicit(&ring->sequences[pos & mask], memory_order_acquire);
+        intptr_t diff = (intptr_t)sequence - (intptr_t)(pos + 1);
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&ring->tail, &pos, pos + 1, memory_order_relaxed, memory_order_relaxed)) break;
+        } else if (diff < 0) {
+            return 0;
+        } else {
+            pos = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+        }
+    }
+    memcpy(record, ring->records + (pos & mask) * ring->recordSize, ring->recordSize);
+    atomic_store_explicit(&ring->sequences[pos & mask], pos + mask + 1, memory_order_release);
+    return 1;
+}
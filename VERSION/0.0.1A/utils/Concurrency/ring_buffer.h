@@ -0,0 +1,28 @@
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+
+/*
+ * Bounded lock-free queue of fixed-size records for any number of producers
+ * and consumers. Each slot carries a sequence number that says whose turn it
+ * is, so a push or pop is one compare-and-swap on the shared index plus a
+ * copy; a full queue rejects the push instead of blocking.
+ */
+typedef struct {
+  size_t capacity;          /* power of two */
+  size_t recordSize;
+  _Atomic size_t *sequences;
+  unsigned char *records;
+  _Alignas(64) _Atomic size_t head;
+  _Alignas(64) _Atomic size_t tail;
+} RingBuffer;
+
+RingBuffer *ringBufferCreate(size_t capacity, size_t recordSize);
+void ringBufferDestroy(RingBuffer *ring);
+
+int ringBufferPush(RingBuffer *ring, const void *record);
+int ringBufferPop(RingBuffer *ring, void *record);
+
+#endif
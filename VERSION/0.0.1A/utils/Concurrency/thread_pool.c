@@ -23,6 +23,7 @@ ThreadPool *threadPoolCreate(int threadCount, int taskQueueSize) {
     pool->taskQueueHead = 0;
     pool->taskQueueTail = 0;
     pool->taskCount = 0;
+    pool->activeCount = 0;
     pool->shutdown = false;
 
     pool->threads = (pthread_t *)malloc(sizeof(pthread_t) * threadCount);
@@ -30,6 +31,7 @@ ThreadPool *threadPoolCreate(int threadCount, int taskQueueSize) {
 
     if (pthread_mutex_init(&(pool->lock), NULL) != 0 ||
         pthread_cond_init(&(pool->notify), NULL) != 0 ||
+        pthread_cond_init(&(pool->idle), NULL) != 0 ||
         pool->threads == NULL || pool->taskQueue == NULL) {
         perror("Failed to initialize thread pool");
         free(pool->threads);
@@ -83,6 +85,24 @@ bool threadPoolAddTask(ThreadPool *pool, void (*function)(void *), void *argumen
     return true;
 }
 
+void threadPoolWait(ThreadPool *pool) {
+    if (pool == NULL) {
+        return;
+    }
+
+    if (pthread_mutex_lock(&(pool->lock)) != 0) {
+        return;
+    }
+
+    while (pool->taskCount > 0 || pool->activeCount > 0) {
+        if (pthread_cond_wait(&(pool->idle), &(pool->lock)) != 0) {
+            break;
+        }
+    }
+
+    pthread_mutex_unlock(&(pool->lock));
+}
+
 void threadPoolDestroy(ThreadPool *pool) {
     int i;
 
@@ -106,7 +126,8 @@ void threadPoolDestroy(ThreadPool *pool) {
         }
     }
 
-    if (pthread_mutex_destroy(&(pool->lock)) != 0 || pthread_cond_destroy(&(pool->notify)) != 0) {
+    if (pthread_mutex_destroy(&(pool->lock)) != 0 || pthread_cond_destroy(&(pool->notify)) != 0 ||
+        pthread_cond_destroy(&(pool->idle)) != 0) {
         return;
     }
 
@@ -140,10 +161,20 @@ static void *threadPoolWorker(void *arg) {
         task.argument = pool->taskQueue[pool->taskQueueHead].argument;
         pool->taskQueueHead = (pool->taskQueueHead + 1) % pool->taskQueueSize;
         pool->taskCount -= 1;
+        pool->activeCount += 1;
 
         pthread_mutex_unlock(&(pool->lock));
 
         (*(task.function))(task.argument);
+
+        if (pthread_mutex_lock(&(pool->lock)) != 0) {
+            break;
+        }
+        pool->activeCount -= 1;
+        if (pool->taskCount == 0 && pool->activeCount == 0) {
+            pthread_cond_broadcast(&(pool->idle));
+        }
+        pthread_mutex_unlock(&(pool->lock));
     }
 
     pthread_exit(NULL);
@@ -12,6 +12,7 @@ typedef struct {
 typedef struct {
     pthread_mutex_t lock;
     pthread_cond_t notify;
+    pthread_cond_t idle;
     pthread_t *threads;
     ThreadTask *taskQueue;
     int threadCount;
@@ -19,11 +20,13 @@ typedef struct {
     int taskQueueHead;
     int taskQueueTail;
     int taskCount;
+    int activeCount;
     bool shutdown;
 } ThreadPool;
 
 ThreadPool *threadPoolCreate(int threadCount, int taskQueueSize);
 bool threadPoolAddTask(ThreadPool *pool, void (*function)(void *), void *argument);
+void threadPoolWait(ThreadPool *pool);
 void threadPoolDestroy(ThreadPool *pool);
 
 #endif 
@@ -0,0 +1,186 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "checkpoint.h"
+#include "../Hash/fnv1a.h"
+
+void checkpointPut(CheckpointBuffer *buffer, const void *data, size_t size) {
+    if (buffer->failed || size == 0) return;
+    if (buffer->size + size > buffer->capacity) {
+        size_t capacity = buffer->capacity ? buffer->capacity : 4096;
+        while (capacity < buffer->size + size) capacity *= 2;
+        unsigned char *grown = (unsigned char *)realloc(buffer->data, capacity);
+        if (!grown) {
+            fprintf(stderr, "Failed to grow checkpoint buffer to %zu bytes\n", capacity);
+            buffer->failed = 1;
+            return;
+        }
+        buffer->data = grown;
+        buffer->capacity = capacity;
+    }
+    memcpy(buffer->data + buffer->size, data, size);
+    buffer->size += size;
+}
+
+/* Returns 1, or 0 once the reader has run out of payload. */
+int checkpointGet(CheckpointReader *reader, void *data, size_t size) {
+    if (reader->failed || size > reader->size - reader->offset) {
+        reader->failed = 1;
+        return 0;
+    }
+    memcpy(data, reader->data + reader->offset, size);
+    reader->offset += size;
+    return 1;
+}
+
+void checkpointBufferFree(CheckpointBuffer *buffer) {
+    free(buffer->data);
+    memset(buffer, 0, sizeof(CheckpointBuffer));
+}
+
+static int writeCheckpoint(const char *path, const CheckpointBuffer *buffer) {
+    CheckpointHeader header = {0};
+    memcpy(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic));
+    header.version = CHECKPOINT_VERSION;
+    header.byteOrder = CHECKPOINT_BYTE_ORDER;
+    header.payloadBytes = buffer->size;
+    header.checksum = fnv1a(buffer->data, buffer->size);
+
+    size_t tmpLen = strlen(path) + 5;
+    char *tmpPath = (char *)malloc(tmpLen);
+    if (!tmpPath) return -1;
+    snprintf(tmpPath, tmpLen, "%s.tmp", path);
+
+    FILE *file = fopen(tmpPath, "wb");
+    if (!file) {
+        perror("Failed to open checkpoint file");
+        free(tmpPath);
+        return -1;
+    }
+    int ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+             (buffer->size == 0 || fwrite(buffer->data, 1, buffer->size, file) == buffer->size);
+    ok = ok && fflush(file) == 0 && fsync(fileno(file)) == 0;
+    ok = (fclose(file) == 0) && ok;
+
+    if (!ok || rename(tmpPath, path) != 0) {
+        perror("Failed to write checkpoint file");
+        unlink(tmpPath);
+        free(tmpPath);
+        return -1;
+    }
+    free(tmpPath);
+    return 0;
+}
+
+static void *writeLoop(void *arg) {
+    Checkpointer *checkpointer = (Checkpointer *)arg;
+    pthread_mutex_lock(&checkpointer->lock);
+    while (1) {
+        while (!checkpointer->hasPending && !checkpointer->stop) {
+            pthread_cond_wait(&checkpointer->wake, &checkpointer->lock);
+        }
+        if (!checkpointer->hasPending) break;
+
+        CheckpointBuffer taken = checkpointer->pending;
+        checkpointer->pending = checkpointer->writing;
+        checkpointer->writing = taken;
+        checkpointer->hasPending = 0;
+        pthread_mutex_unlock(&checkpointer->lock);
+
+        int result = writeCheckpoint(checkpointer->path, &checkpointer->writing);
+
+        pthread_mutex_lock(&checkpointer->lock);
+        if (result == 0) checkpointer->written++;
+    }
+    pthread_mutex_unlock(&checkpointer->lock);
+    return NULL;
+}
+
+Checkpointer *checkpointerCreate(const char *path) {
+    if (!path) return NULL;
+    Checkpointer *checkpointer = (Checkpointer *)calloc(1, sizeof(Checkpointer));
+    if (!checkpointer) return NULL;
+    pthread_mutex_init(&checkpointer->lock, NULL);
+    pthread_cond_init(&checkpointer->wake, NULL);
+
+    checkpointer->path = strdup(path);
+    if (!checkpointer->path || pthread_create(&checkpointer->thread, NULL, writeLoop, checkpointer) != 0) {
+        fprintf(stderr, "Failed to start checkpoint writer for %s\n", path);
+        checkpointerDestroy(checkpointer);
+        return NULL;
+    }
+    checkpointer->started = 1;
+    return checkpointer;
+}
+
+/* Finishes the write in progress and any checkpoint still waiting. */
+void checkpointerDestroy(Checkpointer *checkpointer) {
+    if (!checkpointer) return;
+    if (checkpointer->started) {
+        pthread_mutex_lock(&checkpointer->lock);
+        checkpointer->stop = 1;
+        pthread_cond_signal(&checkpointer->wake);
+        pthread_mutex_unlock(&checkpointer->lock);
+        pthread_join(checkpointer->thread, NULL);
+    }
+    checkpointBufferFree(&checkpointer->pending);
+    checkpointBufferFree(&checkpointer->writing);
+    pthread_mutex_destroy(&checkpointer->lock);
+    pthread_cond_destroy(&checkpointer->wake);
+    free(checkpointer->path);
+    free(checkpointer);
+}
+
+/*
+ * Queues the contents of buffer for writing. buffer is handed back empty,
+ * holding storage from an earlier checkpoint so the caller can refill it
+ * without allocating. Returns 0, or -1 if buffer is incomplete.
+ */
+int checkpointerSubmit(Checkpointer *checkpointer, CheckpointBuffer *buffer) {
+    if (buffer->failed) {
+        buffer->size = 0;
+        buffer->failed = 0;
+        return -1;
+    }
+    pthread_mutex_lock(&checkpointer->lock);
+    if (checkpointer->hasPending) checkpointer->superseded++;
+    CheckpointBuffer previous = checkpointer->pending;
+    checkpointer->pending = *buffer;
+    checkpointer->hasPending = 1;
+    pthread_cond_signal(&checkpointer->wake);
+    pthread_mutex_unlock(&checkpointer->lock);
+
+    *buffer = previous;
+    buffer->size = 0;
+    return 0;
+}
+
+/* Returns the verified payload (free it), or NULL. */
+unsigned char *checkpointRead(const char *path, size_t *payloadBytes) {
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        perror("Failed to open checkpoint file");
+        return NULL;
+    }
+
+    CheckpointHeader header;
+    unsigned char *payload = NULL;
+    int ok = fread(&header, sizeof(header), 1, file) == 1 &&
+             memcmp(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic)) == 0 &&
+             header.version == CHECKPOINT_VERSION && header.byteOrder == CHECKPOINT_BYTE_ORDER;
+    if (ok) {
+        payload = (unsigned char *)malloc(header.payloadBytes ? header.payloadBytes : 1);
+        ok = payload && fread(payload, 1, header.payloadBytes, file) == header.payloadBytes &&
+             fnv1a(payload, header.payloadBytes) == header.checksum;
+    }
+    fclose(file);
+
+    if (!ok) {
+        fprintf(stderr, "Checkpoint %s is not a valid checkpoint\n", path);
+        free(payload);
+        return NULL;
+    }
+    *payloadBytes = header.payloadBytes;
+    return payload;
+}
@@ -0,0 +1,72 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Checkpoint file:
+ *   CheckpointHeader | payload
+ * The payload is whatever the caller serialized with checkpointPut; the
+ * checksum is FNV-1a over it. Files are written to <path>.tmp and renamed
+ * over path, so path always holds the latest complete checkpoint.
+ */
+#define CHECKPOINT_MAGIC "EVOCKPT"
+#define CHECKPOINT_VERSION 2
+#define CHECKPOINT_BYTE_ORDER 0x01020304u
+
+typedef struct {
+  char magic[8];
+  uint32_t version;
+  uint32_t byteOrder;
+  uint64_t payloadBytes;
+  uint64_t checksum;
+} CheckpointHeader;
+
+typedef struct {
+  unsigned char *data;
+  size_t size;
+  size_t capacity;
+  int failed;          /* an allocation failed; the contents are incomplete */
+} CheckpointBuffer;
+
+typedef struct {
+  const unsigned char *data;
+  size_t size;
+  size_t offset;
+  int failed;          /* a read ran past the end */
+} CheckpointReader;
+
+void checkpointPut(CheckpointBuffer *buffer, const void *data, size_t size);
+int checkpointGet(CheckpointReader *reader, void *data, size_t size);
+void checkpointBufferFree(CheckpointBuffer *buffer);
+
+/*
+ * Writes checkpoints on a background thread. Submitting hands the buffer
+ * over and returns at once; if the writer is still busy, a newer
+ * submission replaces the one waiting, so at most one write is ever
+ * queued and the caller never blocks on disk.
+ */
+typedef struct {
+  pthread_mutex_t lock;
+  pthread_cond_t wake;
+  pthread_t thread;
+  char *path;
+  CheckpointBuffer pending;
+  CheckpointBuffer writing;
+  int hasPending;
+  int started;
+  int stop;
+  size_t written;
+  size_t superseded;
+} Checkpointer;
+
+Checkpointer *checkpointerCreate(const char *path);
+void checkpointerDestroy(Checkpointer *checkpointer);
+
+int checkpointerSubmit(Checkpointer *checkpointer, CheckpointBuffer *buffer);
+
+unsigned char *checkpointRead(const char *path, size_t *payloadBytes);
+
+#endif
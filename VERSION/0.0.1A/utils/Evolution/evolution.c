@@ -0,0 +1,171 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "evolution.h"
+
+Evolution *evolutionCreate(size_t capacity, int numWorkers) {
+    if (numWorkers <= 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        numWorkers = online > 0 ? (int)online : 1;
+    }
+
+    Evolution *evolution = (Evolution *)calloc(1, sizeof(Evolution));
+    if (!evolution) return NULL;
+
+    evolution->numWorkers = (unsigned int)numWorkers;
+    evolution->capacity = capacity;
+    evolution->ranking = (size_t *)malloc(sizeof(size_t) * (capacity ? capacity : 1));
+    evolution->workers = (EvolutionWorker *)calloc(numWorkers, sizeof(EvolutionWorker));
+    if (numWorkers > 1) {
+        evolution->pool = threadPoolCreate(numWorkers, numWorkers * 2);
+    }
+    if (!evolution->ranking || !evolution->workers || (numWorkers > 1 && !evolution->pool)) {
+        fprintf(stderr, "Failed to create evolution workers\n");
+        evolutionDestroy(evolution);
+        return NULL;
+    }
+
+    for (int i = 0; i < numWorkers; i++) {
+        evolution->workers[i].evolution = evolution;
+    }
+    return evolution;
+}
+
+void evolutionDestroy(Evolution *evolution) {
+    if (!evolution) return;
+    if (evolution->pool) {
+        threadPoolDestroy(evolution->pool);
+    }
+    free(evolution->workers);
+    free(evolution->ranking);
+    free(evolution);
+}
+
+/* Quickselect: moves the k fittest indices to the front of ranking, unordered. */
+static void selectFittest(size_t *ranking, const double *fitness, size_t n, size_t k) {
+    size_t lo = 0;
+    size_t hi = n;
+    while (k > lo && hi - lo > 1) {
+        double pivot = fitness[ranking[lo + (hi - lo) / 2]];
+        size_t i = lo;
+        size_t j = hi - 1;
+        while (i <= j) {
+            while (fitness[ranking[i]] > pivot) i++;
+            while (fitness[ranking[j]] < pivot) j--;
+            if (i <= j) {
+                size_t t = ranking[i];
+                ranking[i] = ranking[j];
+                ranking[j] = t;
+                i++;
+                if (j == 0) break;
+                j--;
+            }
+        }
+        if (k <= j + 1) {
+            hi = j + 1;
+        } else if (k >= i) {
+            lo = i;
+        } else {
+            break;
+        }
+    }
+}
+
+static size_t pickParent(Evolution *evolution, Rng *rng) {
+    const EvolutionConfig *config = evolution->config;
+    if (config->selection == EVOLUTION_TRUNCATION) {
+        return evolution->ranking[rngBelow(rng, (uint32_t)evolution->numEligible)];
+    }
+
+    unsigned int rounds = config->tournamentSize ? config->tournamentSize : 1;
+    size_t best = rngBelow(rng, (uint32_t)evolution->count);
+    for (unsigned int r = 1; r < rounds; r++) {
+        size_t contender = rngBelow(rng, (uint32_t)evolution->count);
+        if (evolution->fitness[contender] > evolution->fitness[best]) {
+            best = contender;
+        }
+    }
+    return best;
+}
+
+static void breedRange(void *arg) {
+    EvolutionWorker *worker = (EvolutionWorker *)arg;
+    Evolution *evolution = worker->evolution;
+    const EvolutionConfig *config = evolution->config;
+    Rng rng;
+
+    for (size_t c = worker->begin; c < worker->end; c++) {
+        double *child = evolution->children + c * evolution->stride;
+        if (c < config->elites) {
+            memcpy(child, evolution->parents + evolution->ranking[c] * evolution->stride, sizeof(double) * evolution->genomeSize);
+            continue;
+        }
+        rngSeed(&rng, evolution->seed, c);
+        const double *parent1 = evolution->parents + pickParent(evolution, &rng) * evolution->stride;
+        const double *parent2 = evolution->parents + pickParent(evolution, &rng) * evolution->stride;
+        geneticCrossover(parent1, parent2, child, evolution->genomeSize, config->crossoverRate, &rng);
+        geneticMutate(child, evolution->genomeSize, config->mutationRate, config->mutationStddev, &rng);
+    }
+}
+
+int evolutionBreed(Evolution *evolution, const EvolutionConfig *config,
+                   const double *parents, double *children, size_t stride, size_t genomeSize,
+                   const double *fitness, size_t count, uint64_t seed) {
+    if (count == 0) return 0;
+    if (count > UINT32_MAX || parents == children) {
+        fprintf(stderr, "Invalid evolution generation of %zu genomes\n", count);
+        return -1;
+    }
+    if (count > evolution->capacity) {
+        size_t *ranking = (size_t *)realloc(evolution->ranking, sizeof(size_t) * count);
+        if (!ranking) {
+            fprintf(stderr, "Failed to grow evolution ranking to %zu genomes\n", count);
+            return -1;
+        }
+        evolution->ranking = ranking;
+        evolution->capacity = count;
+    }
+
+    evolution->config = config;
+    evolution->parents = parents;
+    evolution->children = children;
+    evolution->fitness = fitness;
+    evolution->count = count;
+    evolution->stride = stride;
+    evolution->genomeSize = genomeSize;
+    evolution->seed = seed;
+
+    size_t elites = config->elites < count ? config->elites : count;
+    size_t eligible = count;
+    if (config->selection == EVOLUTION_TRUNCATION) {
+        eligible = (size_t)(config->truncation * (double)count);
+        eligible = eligible < 1 ? 1 : eligible > count ? count : eligible;
+    }
+    evolution->numEligible = eligible;
+
+    if (elites > 0 || config->selection == EVOLUTION_TRUNCATION) {
+        for (size_t i = 0; i < count; i++) {
+            evolution->ranking[i] = i;
+        }
+        size_t keep = eligible > elites ? eligible : elites;
+        selectFittest(evolution->ranking, fitness, count, keep);
+        if (elites > 0 && elites < keep) {
+            selectFittest(evolution->ranking, fitness, keep, elites);
+        }
+    }
+
+    unsigned int numWorkers = evolution->numWorkers;
+    for (unsigned int w = 0; w < numWorkers; w++) {
+        EvolutionWorker *worker = &evolution->workers[w];
+        worker->begin = count * w / numWorkers;
+        worker->end = count * (w + 1) / numWorkers;
+        if (!evolution->pool || !threadPoolAddTask(evolution->pool, breedRange, worker)) {
+            breedRange(worker);
+        }
+    }
+    if (evolution->pool) {
+        threadPoolWait(evolution->pool);
+    }
+    return 0;
+}
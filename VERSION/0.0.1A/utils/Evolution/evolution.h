@@ -0,0 +1,64 @@
+#ifndef EVOLUTION_H
+#define EVOLUTION_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "../Concurrency/thread_pool.h"
+#include "genetic.h"
+
+typedef enum {
+  EVOLUTION_TOURNAMENT,
+  EVOLUTION_TRUNCATION
+} EvolutionSelection;
+
+typedef struct {
+  EvolutionSelection selection;
+  unsigned int tournamentSize;  /* contestants per parent draw */
+  double truncation;            /* fraction of the population eligible as parents */
+  size_t elites;                /* best genomes copied unchanged into slots 0..elites-1 */
+  double crossoverRate;
+  double mutationRate;
+  double mutationStddev;
+} EvolutionConfig;
+
+typedef struct Evolution Evolution;
+
+typedef struct {
+  Evolution *evolution;
+  size_t begin;
+  size_t end;
+} EvolutionWorker;
+
+/*
+ * Breeds one generation of fixed-size genomes from a parent buffer into a
+ * separate child buffer (both strided, e.g. NNPopulation params/nextParams).
+ * Selection needs no sort: tournaments sample directly, and truncation and
+ * elitism use a linear-time partial selection. Children are bred in
+ * parallel, and child i draws from stream i of the generation's seed, so
+ * the result does not depend on the number of workers.
+ */
+struct Evolution {
+  ThreadPool *pool;
+  EvolutionWorker *workers;
+  unsigned int numWorkers;
+  size_t capacity;
+  size_t *ranking;
+  const EvolutionConfig *config;
+  const double *parents;
+  double *children;
+  const double *fitness;
+  size_t count;
+  size_t stride;
+  size_t genomeSize;
+  size_t numEligible;
+  uint64_t seed;
+};
+
+Evolution *evolutionCreate(size_t capacity, int numWorkers);
+void evolutionDestroy(Evolution *evolution);
+
+int evolutionBreed(Evolution *evolution, const EvolutionConfig *config,
+                   const double *parents, double *children, size_t stride, size_t genomeSize,
+                   const double *fitness, size_t count, uint64_t seed);
+
+#endif
@@ -0,0 +1,31 @@
+#include "genetic.h"
+
+/* Adds roughly N(0, stddev^2) noise to each element with probability rate. */
+void geneticMutate(double *params, size_t n, double rate, double stddev, Rng *rng) {
+    double mask[GENETIC_CHUNK];
+    double noise[GENETIC_CHUNK];
+    for (size_t i = 0; i < n; i += GENETIC_CHUNK) {
+        size_t count = n - i < GENETIC_CHUNK ? n - i : GENETIC_CHUNK;
+        rngUniformBatch(rng, mask, count);
+        rngNormalFastBatch(rng, noise, count);
+        double *restrict p = params + i;
+        for (size_t j = 0; j < count; j++) {
+            p[j] += mask[j] < rate ? stddev * noise[j] : 0.0;
+        }
+    }
+}
+
+/* Uniform crossover: each element comes from parent1 with probability rate. */
+void geneticCrossover(const double *parent1, const double *parent2, double *child, size_t n, double rate, Rng *rng) {
+    double mask[GENETIC_CHUNK];
+    for (size_t i = 0; i < n; i += GENETIC_CHUNK) {
+        size_t count = n - i < GENETIC_CHUNK ? n - i : GENETIC_CHUNK;
+        rngUniformBatch(rng, mask, count);
+        const double *a = parent1 + i;
+        const double *b = parent2 + i;
+        double *c = child + i;
+        for (size_t j = 0; j < count; j++) {
+            c[j] = mask[j] < rate ? a[j] : b[j];
+        }
+    }
+}
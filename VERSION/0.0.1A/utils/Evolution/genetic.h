@@ -0,0 +1,18 @@
+#ifndef GENETIC_H
+#define GENETIC_H
+
+#include <stddef.h>
+#include "../Random/rng.h"
+
+/*
+ * Genetic operators over flat parameter buffers (e.g. NN_t params, which
+ * hold weights and biases in one block). Random masks and perturbations are
+ * drawn in batches and applied with selects rather than per-element
+ * branches, so the loops vectorize.
+ */
+#define GENETIC_CHUNK 256
+
+void geneticMutate(double *params, size_t n, double rate, double stddev, Rng *rng);
+void geneticCrossover(const double *parent1, const double *parent2, double *child, size_t n, double rate, Rng *rng);
+
+#endif
@@ -0,0 +1,49 @@
+#include <stdio.h>
+#include <string.h>
+#include "genome.h"
+#include "../Hash/fnv1a.h"
+
+size_t genomeEncodedSize(size_t numParams) {
+    return sizeof(GenomeHeader) + numParams * sizeof(float);
+}
+
+size_t genomeEncode(void *dst, const double *params, size_t numParams, double fitness, uint32_t origin) {
+    unsigned char *bytes = (unsigned char *)dst;
+    float *payload = (float *)(bytes + sizeof(GenomeHeader));
+    for (size_t i = 0; i < numParams; i++) {
+        payload[i] = (float)params[i];
+    }
+
+    GenomeHeader header = {0};
+    header.magic = GENOME_MAGIC;
+    header.version = GENOME_VERSION;
+    header.numParams = (uint32_t)numParams;
+    header.origin = origin;
+    header.fitness = fitness;
+    header.checksum = fnv1a(payload, numParams * sizeof(float));
+    memcpy(bytes, &header, sizeof(header));
+    return genomeEncodedSize(numParams);
+}
+
+int genomeDecode(const void *src, size_t size, double *params, size_t numParams, double *fitness, uint32_t *origin) {
+    GenomeHeader header;
+    if (size < sizeof(header)) return -1;
+    memcpy(&header, src, sizeof(header));
+    if (header.magic != GENOME_MAGIC || header.version != GENOME_VERSION ||
+        header.numParams != numParams || size < genomeEncodedSize(numParams)) {
+        return -1;
+    }
+
+    const unsigned char *payload = (const unsigned char *)src + sizeof(GenomeHeader);
+    if (fnv1a(payload, numParams * sizeof(float)) != header.checksum) {
+        return -1;
+    }
+    for (size_t i = 0; i < numParams; i++) {
+        float value;
+        memcpy(&value, payload + i * sizeof(float), sizeof(value));
+        params[i] = value;
+    }
+    if (fitness) *fitness = header.fitness;
+    if (origin) *origin = header.origin;
+    return 0;
+}
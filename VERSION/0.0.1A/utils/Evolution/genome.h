@@ -0,0 +1,31 @@
+#ifndef GENOME_H
+#define GENOME_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Compact wire format for one genome:
+ *   GenomeHeader | numParams float32 values
+ * Parameters are narrowed to float32 (migrants get mutated anyway), halving
+ * the bytes on the wire. All fields are host byte order; the checksum is
+ * FNV-1a over the payload.
+ */
+#define GENOME_MAGIC 0x4D4E4547u
+#define GENOME_VERSION 2
+
+typedef struct {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t reserved;
+  uint32_t numParams;
+  uint32_t origin;
+  double fitness;
+  uint64_t checksum;
+} GenomeHeader;
+
+size_t genomeEncodedSize(size_t numParams);
+size_t genomeEncode(void *dst, const double *params, size_t numParams, double fitness, uint32_t origin);
+int genomeDecode(const void *src, size_t size, double *params, size_t numParams, double *fitness, uint32_t *origin);
+
+#endif
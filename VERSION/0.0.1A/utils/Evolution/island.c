@@ -0,0 +1,172 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "island.h"
+
+static int setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags < 0 ? -1 : fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+}
+
+static int socketPath(char *dst, size_t size, const char *dir, const char *name, unsigned int id) {
+    int n = snprintf(dst, size, "%s/%s-%u.sock", dir, name, id);
+    return n > 0 && (size_t)n < size ? 0 : -1;
+}
+
+static void closeFd(int *fd) {
+    if (*fd >= 0) {
+        close(*fd);
+        *fd = -1;
+    }
+}
+
+Island *islandCreate(const char *dir, const char *name, unsigned int id, unsigned int count, size_t numParams) {
+    if (count == 0 || id >= count) return NULL;
+
+    Island *island = (Island *)calloc(1, sizeof(Island));
+    if (!island) return NULL;
+
+    island->id = id;
+    island->count = count;
+    island->numParams = numParams;
+    island->frameSize = genomeEncodedSize(numParams);
+    island->listenFd = -1;
+    island->inFd = -1;
+    island->outFd = -1;
+    island->inBuffer = (unsigned char *)malloc(island->frameSize);
+    island->outBuffer = (unsigned char *)malloc(island->frameSize * ISLAND_BACKLOG);
+    if (!island->inBuffer || !island->outBuffer ||
+        socketPath(island->listenPath, sizeof(island->listenPath), dir, name, id) != 0 ||
+        socketPath(island->neighborPath, sizeof(island->neighborPath), dir, name, (id + 1) % count) != 0) {
+        fprintf(stderr, "Failed to create island %u\n", id);
+        islandDestroy(island);
+        return NULL;
+    }
+
+    struct sockaddr_un addr = {0};
+    addr.sun_family = AF_UNIX;
+    memcpy(addr.sun_path, island->listenPath, sizeof(island->listenPath));
+    unlink(island->listenPath);
+    island->listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (island->listenFd < 0 ||
+        bind(island->listenFd, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+        listen(island->listenFd, 1) != 0 ||
+        setNonBlocking(island->listenFd) != 0) {
+        perror("Failed to listen for migrants");
+        islandDestroy(island);
+        return NULL;
+    }
+
+    return island;
+}
+
+void islandDestroy(Island *island) {
+    if (!island) return;
+    closeFd(&island->inFd);
+    closeFd(&island->outFd);
+    if (island->listenFd >= 0) {
+        closeFd(&island->listenFd);
+        unlink(island->listenPath);
+    }
+    free(island->inBuffer);
+    free(island->outBuffer);
+    free(island);
+}
+
+/* Connects to the neighbour if it is up; a failed attempt is retried on the next call. */
+static void connectNeighbor(Island *island) {
+    if (island->outFd >= 0 || island->count < 2) return;
+
+    struct sockaddr_un addr = {0};
+    addr.sun_family = AF_UNIX;
+    memcpy(addr.sun_path, island->neighborPath, sizeof(island->neighborPath));
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return;
+#ifdef SO_NOSIGPIPE
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || setNonBlocking(fd) != 0) {
+        close(fd);
+        return;
+    }
+    island->outFd = fd;
+    island->outUsed = 0;
+}
+
+static void flush(Island *island) {
+    connectNeighbor(island);
+    if (island->outFd < 0 || island->outUsed == 0) return;
+
+#ifdef MSG_NOSIGNAL
+    ssize_t sent = send(island->outFd, island->outBuffer, island->outUsed, MSG_NOSIGNAL);
+#else
+    ssize_t sent = send(island->outFd, island->outBuffer, island->outUsed, 0);
+#endif
+    if (sent < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            /* The peer went away: drop the backlog so the next connection starts on a frame boundary. */
+            closeFd(&island->outFd);
+            island->outUsed = 0;
+        }
+        return;
+    }
+    memmove(island->outBuffer, island->outBuffer + sent, island->outUsed - (size_t)sent);
+    island->outUsed -= (size_t)sent;
+}
+
+int islandEmigrate(Island *island, const double *params, double fitness) {
+    if (island->count < 2) return 0;
+    flush(island);
+    if (island->outFd < 0 || island->outUsed + island->frameSize > island->frameSize * ISLAND_BACKLOG) {
+        return -1;
+    }
+    genomeEncode(island->outBuffer + island->outUsed, params, island->numParams, fitness, island->id);
+    island->outUsed += island->frameSize;
+    flush(island);
+    return 0;
+}
+
+/* Returns 1 and fills params/fitness when a whole genome has arrived, 0 otherwise. */
+int islandImmigrate(Island *island, double *params, double *fitness) {
+    if (island->count < 2) return 0;
+    flush(island);
+
+    int fd = accept(island->listenFd, NULL, NULL);
+    if (fd >= 0) {
+        if (setNonBlocking(fd) != 0) {
+            close(fd);
+        } else {
+            closeFd(&island->inFd);
+            island->inFd = fd;
+            island->inUsed = 0;
+        }
+    }
+    if (island->inFd < 0) return 0;
+
+    while (island->inUsed < island->frameSize) {
+        ssize_t got = recv(island->inFd, island->inBuffer + island->inUsed, island->frameSize - island->inUsed, 0);
+        if (got > 0) {
+            island->inUsed += (size_t)got;
+        } else if (got == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+            closeFd(&island->inFd);
+            island->inUsed = 0;
+            return 0;
+        } else {
+            return 0;
+        }
+    }
+
+    island->inUsed = 0;
+    if (genomeDecode(island->inBuffer, island->frameSize, params, island->numParams, fitness, NULL) != 0) {
+        fprintf(stderr, "Island %u: dropping corrupt migrant stream\n", island->id);
+        closeFd(&island->inFd);
+        return 0;
+    }
+    return 1;
+}
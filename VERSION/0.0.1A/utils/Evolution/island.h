@@ -0,0 +1,38 @@
+#ifndef ISLAND_H
+#define ISLAND_H
+
+#include <stddef.h>
+#include "genome.h"
+
+/*
+ * One island of a ring of processes exchanging genomes over Unix domain
+ * sockets: island i listens on <dir>/<name>-<i>.sock and sends to island
+ * (i + 1) % count. Everything is non-blocking and best effort: neighbours
+ * may start late or restart, and emigrants are dropped when the outgoing
+ * backlog is full rather than stalling the simulation.
+ */
+#define ISLAND_BACKLOG 8
+
+typedef struct {
+  unsigned int id;
+  unsigned int count;
+  size_t numParams;
+  size_t frameSize;
+  int listenFd;
+  int inFd;
+  int outFd;
+  char listenPath[104];
+  char neighborPath[104];
+  unsigned char *inBuffer;
+  size_t inUsed;
+  unsigned char *outBuffer;
+  size_t outUsed;
+} Island;
+
+Island *islandCreate(const char *dir, const char *name, unsigned int id, unsigned int count, size_t numParams);
+void islandDestroy(Island *island);
+
+int islandEmigrate(Island *island, const double *params, double fitness);
+int islandImmigrate(Island *island, double *params, double *fitness);
+
+#endif
@@ -0,0 +1,254 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "steady.h"
+
+SteadyState *steadyCreate(size_t count, size_t genomeSize, const double *initial, int numWorkers,
+                          const EvolutionConfig *config, SteadyEvaluate evaluate, void *context, uint64_t seed) {
+    if (count == 0 || genomeSize == 0 || !initial || !config || !evaluate) return NULL;
+    if (numWorkers <= 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        numWorkers = online > 0 ? (int)online : 1;
+    }
+
+    SteadyState *steady = (SteadyState *)calloc(1, sizeof(SteadyState));
+    if (!steady) return NULL;
+
+    pthread_mutex_init(&steady->lock, NULL);
+    pthread_cond_init(&steady->queued, NULL);
+    pthread_cond_init(&steady->finished, NULL);
+    steady->numWorkers = (unsigned int)numWorkers;
+    steady->numJobs = (size_t)numWorkers * 2;
+    steady->config = config;
+    steady->evaluate = evaluate;
+    steady->context = context;
+    steady->count = count;
+    steady->genomeSize = genomeSize;
+    steady->population = (double *)malloc(sizeof(double) * count * genomeSize);
+    steady->fitness = (double *)calloc(count, sizeof(double));
+    steady->scored = (unsigned char *)calloc(count, 1);
+    steady->threads = (pthread_t *)calloc(steady->numWorkers, sizeof(pthread_t));
+    steady->workers = (SteadyWorker *)calloc(steady->numWorkers, sizeof(SteadyWorker));
+    steady->jobs = (SteadyJob *)calloc(steady->numJobs, sizeof(SteadyJob));
+    if (!steady->population || !steady->fitness || !steady->scored || !steady->threads ||
+        !steady->workers || !steady->jobs) {
+        fprintf(stderr, "Failed to allocate steady-state evolution\n");
+        steadyDestroy(steady);
+        return NULL;
+    }
+    for (size_t j = 0; j < steady->numJobs; j++) {
+        steady->jobs[j].genome = (double *)malloc(sizeof(double) * genomeSize);
+        if (!steady->jobs[j].genome) {
+            fprintf(stderr, "Failed to allocate steady-state evolution\n");
+            steadyDestroy(steady);
+            return NULL;
+        }
+    }
+
+    memcpy(steady->population, initial, sizeof(double) * count * genomeSize);
+    rngSeed(&steady->rng, seed, 0);
+    return steady;
+}
+
+void steadyDestroy(SteadyState *steady) {
+    if (!steady) return;
+    steadyStop(steady);
+    if (steady->jobs) {
+        for (size_t j = 0; j < steady->numJobs; j++) {
+            free(steady->jobs[j].genome);
+        }
+    }
+    pthread_mutex_destroy(&steady->lock);
+    pthread_cond_destroy(&steady->queued);
+    pthread_cond_destroy(&steady->finished);
+    free(steady->population);
+    free(steady->fitness);
+    free(steady->scored);
+    free(steady->threads);
+    free(steady->workers);
+    free(steady->jobs);
+    free(steady);
+}
+
+static size_t tournament(SteadyState *steady, size_t fallback) {
+    unsigned int size = steady->config->tournamentSize ? steady->config->tournamentSize : 1;
+    size_t best = SIZE_MAX;
+    for (unsigned int t = 0; t < size; t++) {
+        size_t contender = rngBelow(&steady->rng, (uint32_t)steady->count);
+        if (steady->scored[contender] && (best == SIZE_MAX || steady->fitness[contender] > steady->fitness[best])) {
+            best = contender;
+        }
+    }
+    return best == SIZE_MAX ? fallback : best;
+}
+
+static void breed(SteadyState *steady, double *child, size_t fallback) {
+    const double *parent1 = steady->population + tournament(steady, fallback) * steady->genomeSize;
+    const double *parent2 = steady->population + tournament(steady, fallback) * steady->genomeSize;
+    geneticCrossover(parent1, parent2, child, steady->genomeSize, steady->config->crossoverRate, &steady->rng);
+    geneticMutate(child, steady->genomeSize, steady->config->mutationRate, steady->config->mutationStddev, &steady->rng);
+}
+
+/* Called with the lock held. */
+static void absorb(SteadyState *steady, SteadyJob *job) {
+    if (job->slot != SIZE_MAX) {
+        steady->fitness[job->slot] = job->fitness;
+        steady->scored[job->slot] = 1;
+        steady->numScored++;
+    } else {
+        size_t worst = SIZE_MAX;
+        for (size_t i = 0; i < steady->count; i++) {
+            if (steady->scored[i] && (worst == SIZE_MAX || steady->fitness[i] < steady->fitness[worst])) {
+                worst = i;
+            }
+        }
+        if (worst != SIZE_MAX && job->fitness >= steady->fitness[worst]) {
+            memcpy(steady->population + worst * steady->genomeSize, job->genome, sizeof(double) * steady->genomeSize);
+            steady->fitness[worst] = job->fitness;
+        }
+    }
+    steady->evaluations++;
+    if (steady->maxEvaluations && steady->evaluations >= steady->maxEvaluations) {
+        steady->stop = 1;
+    }
+}
+
+static void *breederMain(void *arg) {
+    SteadyState *steady = (SteadyState *)arg;
+    size_t lastScored = 0;
+    pthread_mutex_lock(&steady->lock);
+    while (!steady->stop) {
+        int waiting = 1;
+        for (size_t j = 0; j < steady->numJobs && !steady->stop; j++) {
+            SteadyJob *job = &steady->jobs[j];
+            if (job->state == STEADY_DONE) {
+                if (job->slot != SIZE_MAX) lastScored = job->slot;
+                absorb(steady, job);
+                job->state = STEADY_FREE;
+            }
+            if (job->state != STEADY_FREE) continue;
+
+            if (steady->nextInitial < steady->count) {
+                job->slot = steady->nextInitial++;
+                memcpy(job->genome, steady->population + job->slot * steady->genomeSize, sizeof(double) * steady->genomeSize);
+            } else if (steady->numScored > 0) {
+                job->slot = SIZE_MAX;
+                breed(steady, job->genome, lastScored);
+            } else {
+                continue;
+            }
+            job->seed = rngNext(&steady->rng);
+            job->state = STEADY_QUEUED;
+            pthread_cond_signal(&steady->queued);
+            waiting = 0;
+        }
+        if (waiting && !steady->stop) {
+            pthread_cond_wait(&steady->finished, &steady->lock);
+        }
+    }
+    pthread_cond_broadcast(&steady->queued);
+    pthread_mutex_unlock(&steady->lock);
+    return NULL;
+}
+
+static SteadyJob *takeJob(SteadyState *steady) {
+    for (size_t j = 0; j < steady->numJobs; j++) {
+        if (steady->jobs[j].state == STEADY_QUEUED) {
+            return &steady->jobs[j];
+        }
+    }
+    return NULL;
+}
+
+static void *workerMain(void *arg) {
+    SteadyWorker *worker = (SteadyWorker *)arg;
+    SteadyState *steady = worker->steady;
+    pthread_mutex_lock(&steady->lock);
+    for (;;) {
+        SteadyJob *job = NULL;
+        while (!steady->stop && !(job = takeJob(steady))) {
+            pthread_cond_wait(&steady->queued, &steady->lock);
+        }
+        if (!job) break;
+        job->state = STEADY_RUNNING;
+        pthread_mutex_unlock(&steady->lock);
+
+        double fitness = steady->evaluate(job->genome, steady->genomeSize, job->seed, worker->index, steady->context);
+
+        pthread_mutex_lock(&steady->lock);
+        job->fitness = fitness;
+        job->state = STEADY_DONE;
+        pthread_cond_signal(&steady->finished);
+    }
+    pthread_mutex_unlock(&steady->lock);
+    return NULL;
+}
+
+int steadyStart(SteadyState *steady, size_t maxEvaluations) {
+    if (steady->started) return -1;
+    steady->maxEvaluations = maxEvaluations;
+    steady->stop = 0;
+
+    unsigned int started = 0;
+    for (; started < steady->numWorkers; started++) {
+        steady->workers[started].steady = steady;
+        steady->workers[started].index = started;
+        if (pthread_create(&steady->threads[started], NULL, workerMain, &steady->workers[started]) != 0) break;
+    }
+    if (started < steady->numWorkers || pthread_create(&steady->breeder, NULL, breederMain, steady) != 0) {
+        fprintf(stderr, "Failed to start steady-state evolution threads\n");
+        pthread_mutex_lock(&steady->lock);
+        steady->stop = 1;
+        pthread_cond_broadcast(&steady->queued);
+        pthread_mutex_unlock(&steady->lock);
+        for (unsigned int i = 0; i < started; i++) {
+            pthread_join(steady->threads[i], NULL);
+        }
+        return -1;
+    }
+    steady->started = 1;
+    return 0;
+}
+
+static void joinAll(SteadyState *steady) {
+    pthread_join(steady->breeder, NULL);
+    for (unsigned int i = 0; i < steady->numWorkers; i++) {
+        pthread_join(steady->threads[i], NULL);
+    }
+    steady->started = 0;
+}
+
+/* Blocks until maxEvaluations scores have been folded in; never returns if it was 0. */
+void steadyWait(SteadyState *steady) {
+    if (!steady->started) return;
+    joinAll(steady);
+}
+
+/* Scores still being computed are dropped. */
+void steadyStop(SteadyState *steady) {
+    if (!steady->started) return;
+    pthread_mutex_lock(&steady->lock);
+    steady->stop = 1;
+    pthread_cond_broadcast(&steady->queued);
+    pthread_cond_broadcast(&steady->finished);
+    pthread_mutex_unlock(&steady->lock);
+    joinAll(steady);
+}
+
+/* Copies the fittest scored genome; returns its slot, or SIZE_MAX if nothing is scored yet. */
+size_t steadyBest(SteadyState *steady, double *genome, double *fitness) {
+    pthread_mutex_lock(&steady->lock);
+    size_t best = SIZE_MAX;
+    for (size_t i = 0; i < steady->count; i++) {
+        if (steady->scored[i] && (best == SIZE_MAX || steady->fitness[i] > steady->fitness[best])) {
+            best = i;
+        }
+    }
+    if (best != SIZE_MAX) {
+        if (genome) memcpy(genome, steady->population + best * steady->genomeSize, sizeof(double) * steady->genomeSize);
+        if (fitness) *fitness = steady->fitness[best];
+    }
+    pthread_mutex_unlock(&steady->lock);
+    return best;
+}
@@ -0,0 +1,80 @@
+#ifndef STEADY_H
+#define STEADY_H
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "../Random/rng.h"
+#include "evolution.h"
+
+/* Scores one genome, e.g. by running a headless episode; worker is 0..numWorkers-1. */
+typedef double (*SteadyEvaluate)(const double *genome, size_t genomeSize, uint64_t seed, unsigned int worker, void *context);
+
+typedef enum {
+  STEADY_FREE,
+  STEADY_QUEUED,
+  STEADY_RUNNING,
+  STEADY_DONE
+} SteadyJobState;
+
+typedef struct {
+  SteadyJobState state;
+  size_t slot;      /* population slot being scored, SIZE_MAX for a child */
+  uint64_t seed;
+  double fitness;
+  double *genome;
+} SteadyJob;
+
+typedef struct SteadyState SteadyState;
+
+typedef struct {
+  SteadyState *steady;
+  unsigned int index;
+} SteadyWorker;
+
+/*
+ * Steady-state GA without generation barriers. Evaluator threads take
+ * queued genomes from a small job table and score them; a breeder thread
+ * folds every finished score back in, replacing the worst individual when
+ * the child is at least as fit, and queues a fresh tournament child in its
+ * place. The table holds two jobs per worker so a worker finishing one
+ * always finds another waiting.
+ */
+struct SteadyState {
+  pthread_mutex_t lock;
+  pthread_cond_t queued;    /* a job was queued, or stop was set */
+  pthread_cond_t finished;  /* a job finished */
+  pthread_t breeder;
+  pthread_t *threads;
+  SteadyWorker *workers;
+  unsigned int numWorkers;
+  SteadyJob *jobs;
+  size_t numJobs;
+  const EvolutionConfig *config;
+  SteadyEvaluate evaluate;
+  void *context;
+  double *population;       /* count x genomeSize */
+  double *fitness;
+  unsigned char *scored;
+  size_t count;
+  size_t genomeSize;
+  size_t numScored;
+  size_t nextInitial;
+  size_t evaluations;
+  size_t maxEvaluations;    /* 0: until steadyStop */
+  Rng rng;                  /* breeder only */
+  int started;
+  int stop;
+};
+
+SteadyState *steadyCreate(size_t count, size_t genomeSize, const double *initial, int numWorkers,
+                          const EvolutionConfig *config, SteadyEvaluate evaluate, void *context, uint64_t seed);
+void steadyDestroy(SteadyState *steady);
+
+int steadyStart(SteadyState *steady, size_t maxEvaluations);
+void steadyWait(SteadyState *steady);
+void steadyStop(SteadyState *steady);
+
+size_t steadyBest(SteadyState *steady, double *genome, double *fitness);
+
+#endif
@@ -0,0 +1,18 @@
+#ifndef FNV1A_H
+#define FNV1A_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* 64-bit FNV-1a; the checksum of the model, genome and checkpoint formats. */
+static inline uint64_t fnv1a(const void *data, size_t size) {
+  const unsigned char *bytes = (const unsigned char *)data;
+  uint64_t hash = 14695981039346656037ULL;
+  for (size_t i = 0; i < size; i++) {
+    hash ^= bytes[i];
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+#endif
@@ -1,79 +1,11 @@
 #include <math.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "../Random/rng.h"
+#define NN_TEMPLATE_IMPL
 #include "NN.h"
 
-NN_t *NN_create(unsigned int numInputs, unsigned int numHidden, unsigned int numOutput,
-                ActivationFunction *hiddenActivations, ActivationFunction *hiddenActivationDerivatives,
-                ActivationFunction *outputActivations, ActivationFunction *outputActivationDerivatives,
-                double learningRate, double momentum) {
-    
-    NN_t *nn = (NN_t *)malloc(sizeof(NN_t));
-    if (!nn) return NULL;
-
-    nn->numInputs = numInputs;
-    nn->numHidden = numHidden;
-    nn->numOutput = numOutput;
-    nn->learningRate = learningRate;
-    nn->momentum = momentum;
-
-    nn->inputs = (double *)calloc(numInputs, sizeof(double));
-    nn->hidden = (double *)calloc(numHidden, sizeof(double));
-    nn->output = (double *)calloc(numOutput, sizeof(double));
-
-    nn->numWeights = numInputs * numHidden + numHidden * numOutput;
-    nn->weights = (double *)malloc(sizeof(double) * nn->numWeights);
-    nn->weightsO = (double *)calloc(nn->numWeights, sizeof(double));
-
-    nn->numBiases = numHidden + numOutput;
-    nn->biases = (double *)malloc(sizeof(double) * nn->numBiases);
-    nn->biasesO = (double *)calloc(nn->numBiases, sizeof(double));
-
-    nn->gradient = (double *)calloc(nn->numWeights, sizeof(double));
-    nn->gradientO = (double *)calloc(nn->numWeights, sizeof(double));
-
-    for (unsigned int i = 0; i < nn->numWeights; i++) {
-        nn->weights[i] = ((double)rand() / RAND_MAX) * 2 - 1;
-    }
-    for (unsigned int i = 0; i < nn->numBiases; i++) {
-        nn->biases[i] = ((double)rand() / RAND_MAX) * 2 - 1;  
-    }
-
-    nn->hiddenActivations = (ActivationFunction *)malloc(numHidden * sizeof(ActivationFunction));
-    nn->outputActivations = (ActivationFunction *)malloc(numOutput * sizeof(ActivationFunction));
-    nn->hiddenActivationDerivatives = (ActivationFunction *)malloc(numHidden * sizeof(ActivationFunction));
-    nn->outputActivationDerivatives = (ActivationFunction *)malloc(numOutput * sizeof(ActivationFunction));
-
-    if (!nn->hiddenActivations || !nn->outputActivations || !nn->hiddenActivationDerivatives || !nn->outputActivationDerivatives) {
-        NN_destroy(nn);
-        return NULL;
-    }
-
-    for (unsigned int i = 0; i < numHidden; i++) {
-        nn->hiddenActivations[i] = hiddenActivations[i];
-        nn->hiddenActivationDerivatives[i] = hiddenActivationDerivatives[i];
-    }
-    for (unsigned int i = 0; i < numOutput; i++) {
-        nn->outputActivations[i] = outputActivations[i];
-        nn->outputActivationDerivatives[i] = outputActivationDerivatives[i];
-    }
-
-    return nn;
-}
-
-void NN_destroy(NN_t *nn) {
-  free(nn->inputs);
-  free(nn->hidden);
-  free(nn->output);
-  free(nn->weights);
-  free(nn->weightsO);
-  free(nn->biases);
-  free(nn->biasesO);
-  free(nn->gradient);
-  free(nn->gradientO);
-  free(nn);
-}
-
-
 void add_matrices(double* C, double* A, double* B, unsigned int n) {
     for (int i = 0; i < n * n; i++) {
         C[i] = A[i] + B[i];
@@ -211,64 +143,6 @@ double *matmul(double *A1, double *A2, double *A3, unsigned int n) {
   return C;
 }
 
-void forward(NN_t *nn, double *input) {
-    for (int i = 0; i < nn->numInputs; i++) {
-        nn->inputs[i] = input[i];
-    }
-    double *hidden_input = matmul(nn->inputs, nn->weights, nn->biases, nn->numHidden);
-    for (int i = 0; i < nn->numHidden; i++) {
-        nn->hidden[i] = nn->hiddenActivations[i](hidden_input[i]);  
-    }
-    free(hidden_input);
-
-    double *output_input = matmul(nn->hidden, &nn->weights[nn->numInputs * nn->numHidden], &nn->biases[nn->numHidden], nn->numOutput);
-    for (int i = 0; i < nn->numOutput; i++) {
-        nn->output[i] = nn->outputActivations[i](output_input[i]);  
-    }
-    free(output_input);
-}
-
-void backprop(NN_t *nn, double *target) {
-    double *output_error = (double *)malloc(sizeof(double) * nn->numOutput);
-    for (int i = 0; i < nn->numOutput; i++) {
-        double derivative = nn->outputActivationDerivatives[i](nn->output[i]);
-        output_error[i] = (nn->output[i] - target[i]) * derivative;
-    }
-
-    double *hidden_error = (double *)malloc(sizeof(double) * nn->numHidden);
-    for (int i = 0; i < nn->numHidden; i++) {
-        hidden_error[i] = 0.0;
-        for (int j = 0; j < nn->numOutput; j++) {
-            hidden_error[i] += output_error[j] * nn->weights[nn->numInputs * nn->numHidden + j * nn->numHidden + i];
-        }
-        double derivative = nn->hiddenActivationDerivatives[i](nn->hidden[i]);
-        hidden_error[i] *= derivative;
-    }
-
-    for (int i = 0; i < nn->numOutput; i++) {
-        for (int j = 0; j < nn->numHidden; j++) {
-            int index = nn->numInputs * nn->numHidden + i * nn->numHidden + j;
-            double delta = -nn->learningRate * output_error[i] * nn->hidden[j];
-            nn->weights[index] += delta + nn->momentum * nn->weightsO[index];
-            nn->weightsO[index] = delta;
-        }
-        nn->biases[nn->numHidden + i] += -nn->learningRate * output_error[i];
-    }
-
-    for (int i = 0; i < nn->numHidden; i++) {
-        for (int j = 0; j < nn->numInputs; j++) {
-            int index = i * nn->numInputs + j;
-            double delta = -nn->learningRate * hidden_error[i] * nn->inputs[j];
-            nn->weights[index] += delta + nn->momentum * nn->weightsO[index];
-            nn->weightsO[index] = delta;
-        }
-        nn->biases[i] += -nn->learningRate * hidden_error[i];
-    }
-
-    free(output_error);
-    free(hidden_error);
-}
-
 double sigmoid(double x) {
   return 1.0 / (1.0 + exp(-x));
 }
@@ -277,8 +151,8 @@ double sigmoid_derivative(double x) {
   return x * (1.0 - x);
 }
 
-double tanh(double x) {
-  return exp(x) - exp(-x) / exp(x) + exp(-x);; 
+double tanh_activation(double x) {
+  return tanh(x);
 }
 
 double tanh_derivative(double x) {
@@ -293,20 +167,28 @@ double relu_derivative(double x) {
   return x > 0 ? 1 : 0;
 }
 
-double softmax(double x, double *xs) {
-  double sum = 0.0;
-  for (size_t i = 0; i < sizeof(xs)/sizeof(xs[0]); i++) {
-    sum += exp(xs[i]);
-  }
-  return exp(x) / sum;
+float sigmoid32(float x) {
+  return 1.0f / (1.0f + expf(-x));
 }
 
-double softmax_derivative(double x, double *xs) {
-  double sum = 0.0;
-  for (size_t i = 0; i < sizeof(xs)/sizeof(xs[0]); i++) {
-    sum += exp(xs[i]);
-  }
-  return exp(x) * sum;
+float sigmoid_derivative32(float x) {
+  return x * (1.0f - x);
+}
+
+float tanh_activation32(float x) {
+  return tanhf(x);
+}
+
+float tanh_derivative32(float x) {
+  return 1.0f - x * x;
+}
+
+float relu32(float x) {
+  return x > 0.0f ? x : 0.0f;
+}
+
+float relu_derivative32(float x) {
+  return x > 0.0f ? 1.0f : 0.0f;
 }
 
 double cross_entropy(double *target, double *output, int num_samples) {
@@ -340,15 +222,3 @@ double mean_squared_error_derivative(double *target, double *output, int num_sam
   }
   return error / num_samples;
 }
-
-double *train(NN_t *nn, double *input, double *target, int num_samples, int num_epochs) {
-  for (int epoch = 0; epoch < num_epochs; epoch++) {
-    for (int i = 0; i < num_samples; i++) {
-      forward(nn, input + i * nn->numInputs);
-      backprop(nn, target + i * nn->numOutput);
-    }
-    printf("Epoch %d: Error = %.6f\n", epoch, nn->error);
-  }
-  return nn->output;
-}
-
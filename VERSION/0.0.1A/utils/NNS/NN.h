@@ -5,40 +5,59 @@
 #include <stdio.h>
 #include <stdlib.h>
 
-typedef double (*ActivationFunction)(double);
+typedef enum {
+  NN_SGD,
+  NN_MOMENTUM,
+  NN_ADAM,
+  NN_RMSPROP
+} NNOptimizerKind;
 
 typedef struct {
-  unsigned int numInputs; 
-  double *inputs;
-  unsigned int numHidden;
-  double *hidden;
-  unsigned int numOutput;
-  double *output;
-  unsigned int numWeights;
-  double *weights;
-  double *weightsO;
-  unsigned int numBiases;
-  double *biases;
-  double *biasesO;
-  double learningRate;
-  double momentum;
-  double error;
-  double *gradient;
-  double *gradientO;
-  ActivationFunction *hiddenActivations;
-  ActivationFunction *outputActivations;
-  ActivationFunction *hiddenActivationDerivatives;
-  ActivationFunction *outputActivationDerivatives;
-} NN_t;
-
-NN_t *NN_create(unsigned int numInputs, unsigned int numHidden, unsigned int numOutput,ActivationFunction *hiddenActivations, ActivationFunction *outputActivations, ActivationFunction *hiddenActivationDerivatives, ActivationFunction *outputActivationDerivatives, double learningRate, double momentum);
-
-void NN_destroy(NN_t *nn);
-
-void forward(NN_t *nn, double *input);
-void backprop(NN_t *nn, double *target);
-double *train(NN_t *nn, double *input, double *target, int num_samples, int num_epochs); 
-void test(NN_t *nn, double *inputs, double *targets, int num_samples); 
+  NNOptimizerKind kind;
+  double beta1;
+  double beta2;
+  double epsilon;
+  unsigned long step;
+} NNOptimizer;
+
+typedef enum {
+  NN_LOSS_MSE,
+  NN_LOSS_SOFTMAX_CROSS_ENTROPY
+} NNLoss;
+
+/* double precision: NN_t, NN_create, forward, backprop, train, test */
+#define NN_REAL double
+#define NN_SUFFIX
+#define NN_SQRT sqrt
+#define NN_EXP exp
+#define NN_LOG log
+#include "NN_template.h"
+#undef NN_LOG
+#undef NN_EXP
+#undef NN_SQRT
+#undef NN_SUFFIX
+#undef NN_REAL
+
+/* single precision: NN32_t, NN32_create, forward32, backprop32, train32, test32 */
+#define NN_REAL float
+#define NN_SUFFIX 32
+#define NN_SQRT sqrtf
+#define NN_EXP expf
+#define NN_LOG logf
+#include "NN_template.h"
+#undef NN_LOG
+#undef NN_EXP
+#undef NN_SQRT
+#undef NN_SUFFIX
+#undef NN_REAL
+
+#define NN_FORWARD(nn, input) _Generic((nn), NN_t *: forward, NN32_t *: forward32)(nn, input)
+#define NN_BACKPROP(nn, target) _Generic((nn), NN_t *: backprop, NN32_t *: backprop32)(nn, target)
+#define NN_TRAIN(nn, input, target, num_samples, num_epochs) \
+    _Generic((nn), NN_t *: train, NN32_t *: train32)(nn, input, target, num_samples, num_epochs)
+#define NN_TEST(nn, inputs, targets, num_samples) \
+    _Generic((nn), NN_t *: test, NN32_t *: test32)(nn, inputs, targets, num_samples)
+#define NN_DESTROY(nn) _Generic((nn), NN_t *: NN_destroy, NN32_t *: NN32_destroy)(nn)
 
 double sigmoid(double x);
 double sigmoid_derivative(double x);
@@ -47,6 +66,13 @@ double relu_derivative(double x);
 double tanh_activation(double x);
 double tanh_derivative(double x);
 
+float sigmoid32(float x);
+float sigmoid_derivative32(float x);
+float relu32(float x);
+float relu_derivative32(float x);
+float tanh_activation32(float x);
+float tanh_derivative32(float x);
+
 double mean_squared_error(double *target, double *output, int num_samples);
 double mean_squared_error_derivative(double *target, double *output, int num_samples);
 double cross_entropy(double *target, double *output, int num_samples);
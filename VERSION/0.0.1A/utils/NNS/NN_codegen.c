@@ -0,0 +1,230 @@
+#include <dlfcn.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "NN_codegen.h"
+#include "NN_model.h"
+
+static const char *activation_name(NNActivationKind kind) {
+    switch (kind) {
+    case NN_ACT_SIGMOID: return "nn_sigmoid";
+    case NN_ACT_RELU: return "nn_relu";
+    case NN_ACT_TANH: return "tanh";
+    case NN_ACT_LINEAR: return "nn_linear";
+    default: return NULL;
+    }
+}
+
+static int valid_symbol(const char *symbol) {
+    if (!symbol || !(*symbol == '_' || (*symbol >= 'A' && *symbol <= 'Z') || (*symbol >= 'a' && *symbol <= 'z'))) return 0;
+    for (const char *c = symbol; *c; c++) {
+        if (!(*c == '_' || (*c >= '0' && *c <= '9') || (*c >= 'A' && *c <= 'Z') || (*c >= 'a' && *c <= 'z'))) return 0;
+    }
+    return 1;
+}
+
+/* Writes rows x cols of src, stored row-major with stride cols, as the transposed [cols][rows] array. */
+static void emit_transposed(FILE *out, const char *name, const double *src, unsigned int rows, unsigned int cols) {
+    fprintf(out, "static const double %s[%u][%u] = {\n", name, cols, rows);
+    for (unsigned int c = 0; c < cols; c++) {
+        fprintf(out, "    {");
+        for (unsigned int r = 0; r < rows; r++) {
+            fprintf(out, "%s%a", r ? ", " : "", src[(size_t)r * cols + c]);
+        }
+        fprintf(out, "},\n");
+    }
+    fprintf(out, "};\n");
+}
+
+static void emit_vector(FILE *out, const char *name, const double *src, unsigned int n) {
+    fprintf(out, "static const double %s[%u] = {", name, n);
+    for (unsigned int i = 0; i < n; i++) {
+        fprintf(out, "%s%a", i ? ", " : "", src[i]);
+    }
+    fprintf(out, "};\n");
+}
+
+/* One loop when the whole layer shares an activation, otherwise one statement per neuron. */
+static void emit_activations(FILE *out, const char *values, const char *count, const NNActivationKind *kinds, unsigned int n) {
+    int uniform = 1;
+    for (unsigned int i = 1; i < n; i++) {
+        uniform &= kinds[i] == kinds[0];
+    }
+    if (uniform) {
+        if (kinds[0] != NN_ACT_LINEAR) {
+            fprintf(out, "    for (int i = 0; i < %s; i++) %s[i] = %s(%s[i]);\n", count, values, activation_name(kinds[0]), values);
+        }
+        return;
+    }
+    for (unsigned int i = 0; i < n; i++) {
+        if (kinds[i] != NN_ACT_LINEAR) {
+            fprintf(out, "    %s[%u] = %s(%s[%u]);\n", values, i, activation_name(kinds[i]), values, i);
+        }
+    }
+}
+
+int NN_codegen(const NN_t *nn, const char *symbol, FILE *out) {
+    if (!valid_symbol(symbol)) {
+        fprintf(stderr, "Invalid evaluator symbol %s\n", symbol ? symbol : "(null)");
+        return -1;
+    }
+    for (unsigned int i = 0; i < nn->numParams; i++) {
+        if (!isfinite(nn->params[i])) {
+            fprintf(stderr, "Cannot generate code for a network with non-finite parameters\n");
+            return -1;
+        }
+    }
+    NNActivationKind *kinds = (NNActivationKind *)malloc(sizeof(NNActivationKind) * (nn->numHidden + nn->numOutput));
+    if (!kinds) return -1;
+    for (unsigned int i = 0; i < nn->numHidden + nn->numOutput; i++) {
+        ActivationFunction f = i < nn->numHidden ? nn->hiddenActivations[i] : nn->outputActivations[i - nn->numHidden];
+        kinds[i] = NN_activation_kind(f);
+        if (!activation_name(kinds[i])) {
+            fprintf(stderr, "Cannot generate code for a custom activation function\n");
+            free(kinds);
+            return -1;
+        }
+    }
+
+    const double *weightsIH = nn->params;
+    const double *weightsHO = nn->params + (size_t)nn->numInputs * nn->numHidden;
+    const double *biases = nn->params + nn->numWeights;
+
+    fprintf(out, "/* Generated by NN_codegen for a %u-%u-%u network. Do not edit. */\n", nn->numInputs, nn->numHidden, nn->numOutput);
+    fprintf(out, "#include <math.h>\n\n");
+    fprintf(out, "#define NN_INPUTS %u\n#define NN_HIDDEN %u\n#define NN_OUTPUTS %u\n\n", nn->numInputs, nn->numHidden, nn->numOutput);
+    fprintf(out, "const unsigned int %s_shape[3] = {NN_INPUTS, NN_HIDDEN, NN_OUTPUTS};\n\n", symbol);
+    emit_transposed(out, "WEIGHTS_IH", weightsIH, nn->numHidden, nn->numInputs);
+    emit_transposed(out, "WEIGHTS_HO", weightsHO, nn->numOutput, nn->numHidden);
+    emit_vector(out, "BIASES_H", biases, nn->numHidden);
+    emit_vector(out, "BIASES_O", biases + nn->numHidden, nn->numOutput);
+
+    /* Same definitions as NN.c, so results match the library's. */
+    fprintf(out, "\nstatic inline double nn_sigmoid(double x) { return 1.0 / (1.0 + exp(-x)); }\n");
+    fprintf(out, "static inline double nn_relu(double x) { return x > 0 ? x : 0; }\n\n");
+
+    fprintf(out, "void %s(const double *restrict input, double *restrict output) {\n", symbol);
+    fprintf(out, "    double hidden[NN_HIDDEN];\n");
+    fprintf(out, "    for (int j = 0; j < NN_HIDDEN; j++) hidden[j] = 0;\n");
+    fprintf(out, "    for (int i = 0; i < NN_INPUTS; i++) {\n");
+    fprintf(out, "        const double x = input[i];\n");
+    fprintf(out, "        for (int j = 0; j < NN_HIDDEN; j++) hidden[j] += WEIGHTS_IH[i][j] * x;\n");
+    fprintf(out, "    }\n");
+    fprintf(out, "    for (int j = 0; j < NN_HIDDEN; j++) hidden[j] += BIASES_H[j];\n");
+    emit_activations(out, "hidden", "NN_HIDDEN", kinds, nn->numHidden);
+    fprintf(out, "    double result[NN_OUTPUTS] = {0};\n");
+    fprintf(out, "    for (int i = 0; i < NN_HIDDEN; i++) {\n");
+    fprintf(out, "        const double h = hidden[i];\n");
+    fprintf(out, "        for (int j = 0; j < NN_OUTPUTS; j++) result[j] += WEIGHTS_HO[i][j] * h;\n");
+    fprintf(out, "    }\n");
+    fprintf(out, "    for (int j = 0; j < NN_OUTPUTS; j++) result[j] += BIASES_O[j];\n");
+    emit_activations(out, "result", "NN_OUTPUTS", kinds + nn->numHidden, nn->numOutput);
+    fprintf(out, "    for (int j = 0; j < NN_OUTPUTS; j++) output[j] = result[j];\n");
+    fprintf(out, "}\n");
+
+    free(kinds);
+    return ferror(out) ? -1 : 0;
+}
+
+/* Generates <sharedPath>.c and builds it into sharedPath. */
+int NN_compile(const NN_t *nn, const char *symbol, const char *sharedPath) {
+    size_t sourceLen = strlen(sharedPath) + 3;
+    char *sourcePath = (char *)malloc(sourceLen);
+    if (!sourcePath) return -1;
+    snprintf(sourcePath, sourceLen, "%s.c", sharedPath);
+
+    FILE *source = fopen(sourcePath, "w");
+    if (!source) {
+        perror("Failed to open generated source");
+        free(sourcePath);
+        return -1;
+    }
+    int ok = NN_codegen(nn, symbol, source) == 0;
+    ok = (fclose(source) == 0) && ok;
+    if (!ok) {
+        free(sourcePath);
+        return -1;
+    }
+
+    const char *cc = getenv("CC");
+    char *argv[] = {(char *)(cc && *cc ? cc : "cc"), "-std=c99", "-O3", "-shared", "-fPIC",
+                    "-o", (char *)sharedPath, sourcePath, "-lm", NULL};
+    fflush(NULL);
+    pid_t pid = fork();
+    if (pid == 0) {
+        execvp(argv[0], argv);
+        perror("Failed to run the C compiler");
+        _exit(127);
+    }
+    int status = 0;
+    if (pid < 0 || waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        fprintf(stderr, "Failed to compile %s\n", sourcePath);
+        free(sourcePath);
+        return -1;
+    }
+    free(sourcePath);
+    return 0;
+}
+
+NNCompiled *NN_compiled_load(const char *sharedPath, const char *symbol) {
+    if (!valid_symbol(symbol)) return NULL;
+    void *handle = dlopen(sharedPath, RTLD_NOW | RTLD_LOCAL);
+    if (!handle) {
+        fprintf(stderr, "Failed to load %s: %s\n", sharedPath, dlerror());
+        return NULL;
+    }
+
+    char shapeName[256];
+    snprintf(shapeName, sizeof(shapeName), "%s_shape", symbol);
+    const unsigned int *shape = (const unsigned int *)dlsym(handle, shapeName);
+    NNCompiled *compiled = (NNCompiled *)calloc(1, sizeof(NNCompiled));
+    if (compiled) {
+        *(void **)&compiled->forward = dlsym(handle, symbol);
+    }
+    if (!compiled || !shape || !compiled->forward) {
+        fprintf(stderr, "%s does not export evaluator %s\n", sharedPath, symbol);
+        free(compiled);
+        dlclose(handle);
+        return NULL;
+    }
+    compiled->handle = handle;
+    compiled->numInputs = shape[0];
+    compiled->numHidden = shape[1];
+    compiled->numOutput = shape[2];
+    return compiled;
+}
+
+void NN_compiled_close(NNCompiled *compiled) {
+    if (!compiled) return;
+    dlclose(compiled->handle);
+    free(compiled);
+}
+
+/* Largest |difference| between the compiled evaluator and NN_infer over the samples, or -1 on a shape mismatch. */
+double NN_compiled_compare(const NN_t *nn, const NNCompiled *compiled, const double *inputs, int numSamples) {
+    if (compiled->numInputs != nn->numInputs || compiled->numHidden != nn->numHidden || compiled->numOutput != nn->numOutput) {
+        return -1;
+    }
+    double *hidden = (double *)malloc(sizeof(double) * nn->numHidden);
+    double *expected = (double *)malloc(sizeof(double) * nn->numOutput);
+    double *actual = (double *)malloc(sizeof(double) * nn->numOutput);
+    double maxDelta = -1;
+    if (hidden && expected && actual) {
+        maxDelta = 0;
+        for (int s = 0; s < numSamples; s++) {
+            const double *input = inputs + (size_t)s * nn->numInputs;
+            NN_infer(nn, input, hidden, expected);
+            compiled->forward(input, actual);
+            for (unsigned int i = 0; i < nn->numOutput; i++) {
+                double delta = fabs(expected[i] - actual[i]);
+                if (delta > maxDelta || isnan(delta)) maxDelta = delta;
+            }
+        }
+    }
+    free(hidden);
+    free(expected);
+    free(actual);
+    return maxDelta;
+}
@@ -0,0 +1,37 @@
+#ifndef NN_CODEGEN_H
+#define NN_CODEGEN_H
+
+#include <stdio.h>
+#include "NN.h"
+
+/*
+ * Ahead-of-time specialization of a trained NN_t. NN_codegen writes a C
+ * translation unit in which the shape is a set of compile-time constants,
+ * the weights are static const arrays (transposed so the inner loops run
+ * over contiguous outputs and vectorize without reassociation) and the
+ * activations are inlined by kind. The unit exports
+ *   void SYMBOL(const double *input, double *output);
+ *   const unsigned int SYMBOL_shape[3];   inputs, hidden, outputs
+ * NN_compile builds it into a shared object with $CC (default cc), and
+ * NN_compiled_load dlopens one. Only sigmoid, relu, tanh and linear
+ * activations can be generated.
+ */
+typedef void (*NNCompiledForward)(const double *input, double *output);
+
+typedef struct {
+  void *handle;
+  NNCompiledForward forward;
+  unsigned int numInputs;
+  unsigned int numHidden;
+  unsigned int numOutput;
+} NNCompiled;
+
+int NN_codegen(const NN_t *nn, const char *symbol, FILE *out);
+int NN_compile(const NN_t *nn, const char *symbol, const char *sharedPath);
+
+NNCompiled *NN_compiled_load(const char *sharedPath, const char *symbol);
+void NN_compiled_close(NNCompiled *compiled);
+
+double NN_compiled_compare(const NN_t *nn, const NNCompiled *compiled, const double *inputs, int numSamples);
+
+#endif
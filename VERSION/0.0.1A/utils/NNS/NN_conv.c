@@ -0,0 +1,308 @@
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../Random/rng.h"
+#include "NN_conv.h"
+
+NNConv2D *NNConv2D_create(unsigned int inChannels, unsigned int inRows, unsigned int inCols,
+                          unsigned int outChannels, unsigned int kernelSize, unsigned int stride, unsigned int padding,
+                          ActivationFunction activation, ActivationFunction activationDerivative, double learningRate) {
+    if (kernelSize == 0 || stride == 0 || inRows + 2 * padding < kernelSize || inCols + 2 * padding < kernelSize) {
+        fprintf(stderr, "Invalid Conv2D geometry\n");
+        return NULL;
+    }
+
+    NNConv2D *conv = (NNConv2D *)calloc(1, sizeof(NNConv2D));
+    if (!conv) return NULL;
+
+    conv->inChannels = inChannels;
+    conv->inRows = inRows;
+    conv->inCols = inCols;
+    conv->outChannels = outChannels;
+    conv->kernelSize = kernelSize;
+    conv->stride = stride;
+    conv->padding = padding;
+    conv->outRows = (inRows + 2 * padding - kernelSize) / stride + 1;
+    conv->outCols = (inCols + 2 * padding - kernelSize) / stride + 1;
+    conv->learningRate = learningRate;
+    conv->activation = activation;
+    conv->activationDerivative = activationDerivative;
+
+    size_t patch = (size_t)inChannels * kernelSize * kernelSize;
+    size_t pixels = (size_t)conv->outRows * conv->outCols;
+    conv->numWeights = (unsigned int)(outChannels * patch);
+    conv->weights = (double *)malloc(sizeof(double) * conv->numWeights);
+    conv->biases = (double *)calloc(outChannels, sizeof(double));
+    conv->gradWeights = (double *)calloc(conv->numWeights, sizeof(double));
+    conv->gradBiases = (double *)calloc(outChannels, sizeof(double));
+    conv->columns = (double *)calloc(patch * pixels, sizeof(double));
+    conv->gradColumns = (double *)calloc(patch * pixels, sizeof(double));
+    conv->output = (double *)calloc(outChannels * pixels, sizeof(double));
+    conv->delta = (double *)calloc(outChannels * pixels, sizeof(double));
+    conv->gradInput = (double *)calloc((size_t)inChannels * inRows * inCols, sizeof(double));
+    if (!conv->weights || !conv->biases || !conv->gradWeights || !conv->gradBiases || !conv->columns ||
+        !conv->gradColumns || !conv->output || !conv->delta || !conv->gradInput) {
+        fprintf(stderr, "Failed to allocate Conv2D layer\n");
+        NNConv2D_destroy(conv);
+        return NULL;
+    }
+
+    double bound = 1.0 / sqrt((double)patch);
+    rngUniformBatch(rngThread(), conv->weights, conv->numWeights);
+    for (unsigned int i = 0; i < conv->numWeights; i++) {
+        conv->weights[i] = (conv->weights[i] * 2 - 1) * bound;
+    }
+
+    return conv;
+}
+
+void NNConv2D_destroy(NNConv2D *conv) {
+    if (!conv) return;
+    free(conv->weights);
+    free(conv->biases);
+    free(conv->gradWeights);
+    free(conv->gradBiases);
+    free(conv->columns);
+    free(conv->gradColumns);
+    free(conv->output);
+    free(conv->delta);
+    free(conv->gradInput);
+    free(conv);
+}
+
+unsigned int NNConv2D_output_size(const NNConv2D *conv) {
+    return conv->outChannels * conv->outRows * conv->outCols;
+}
+
+/* columns[(c * k + ki) * k + kj][oy * outCols + ox] = input[c][oy * s + ki - p][ox * s + kj - p] */
+static void im2col(NNConv2D *conv, const double *input) {
+    unsigned int k = conv->kernelSize;
+    size_t pixels = (size_t)conv->outRows * conv->outCols;
+    for (unsigned int c = 0; c < conv->inChannels; c++) {
+        const double *plane = input + (size_t)c * conv->inRows * conv->inCols;
+        for (unsigned int ki = 0; ki < k; ki++) {
+            for (unsigned int kj = 0; kj < k; kj++) {
+                double *col = conv->columns + ((size_t)(c * k + ki) * k + kj) * pixels;
+                for (unsigned int oy = 0; oy < conv->outRows; oy++) {
+                    long iy = (long)oy * conv->stride + ki - conv->padding;
+                    double *dst = col + (size_t)oy * conv->outCols;
+                    if (iy < 0 || iy >= (long)conv->inRows) {
+                        memset(dst, 0, sizeof(double) * conv->outCols);
+                        continue;
+                    }
+                    const double *row = plane + (size_t)iy * conv->inCols;
+                    for (unsigned int ox = 0; ox < conv->outCols; ox++) {
+                        long ix = (long)ox * conv->stride + kj - conv->padding;
+                        dst[ox] = (ix >= 0 && ix < (long)conv->inCols) ? row[ix] : 0.0;
+                    }
+                }
+            }
+        }
+    }
+}
+
+static void col2im(NNConv2D *conv) {
+    unsigned int k = conv->kernelSize;
+    size_t pixels = (size_t)conv->outRows * conv->outCols;
+    memset(conv->gradInput, 0, sizeof(double) * conv->inChannels * conv->inRows * conv->inCols);
+    for (unsigned int c = 0; c < conv->inChannels; c++) {
+        double *plane = conv->gradInput + (size_t)c * conv->inRows * conv->inCols;
+        for (unsigned int ki = 0; ki < k; ki++) {
+            for (unsigned int kj = 0; kj < k; kj++) {
+                const double *col = conv->gradColumns + ((size_t)(c * k + ki) * k + kj) * pixels;
+                for (unsigned int oy = 0; oy < conv->outRows; oy++) {
+                    long iy = (long)oy * conv->stride + ki - conv->padding;
+                    if (iy < 0 || iy >= (long)conv->inRows) continue;
+                    double *row = plane + (size_t)iy * conv->inCols;
+                    const double *src = col + (size_t)oy * conv->outCols;
+                    for (unsigned int ox = 0; ox < conv->outCols; ox++) {
+                        long ix = (long)ox * conv->stride + kj - conv->padding;
+                        if (ix >= 0 && ix < (long)conv->inCols) {
+                            row[ix] += src[ox];
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+void NNConv2D_forward(NNConv2D *conv, const double *input) {
+    size_t patch = (size_t)conv->inChannels * conv->kernelSize * conv->kernelSize;
+    size_t pixels = (size_t)conv->outRows * conv->outCols;
+
+    im2col(conv, input);
+
+    for (unsigned int oc = 0; oc < conv->outChannels; oc++) {
+        double *restrict out = conv->output + oc * pixels;
+        const double *w = conv->weights + oc * patch;
+        for (size_t p = 0; p < pixels; p++) {
+            out[p] = conv->biases[oc];
+        }
+        for (size_t r = 0; r < patch; r++) {
+            double weight = w[r];
+            const double *restrict col = conv->columns + r * pixels;
+            for (size_t p = 0; p < pixels; p++) {
+                out[p] += weight * col[p];
+            }
+        }
+        for (size_t p = 0; p < pixels; p++) {
+            out[p] = conv->activation(out[p]);
+        }
+    }
+}
+
+/*
+ * gradOutput is dLoss/dOutput for the last forward pass. Weight and bias
+ * gradients accumulate until NNConv2D_update; conv->gradInput receives
+ * dLoss/dInput for the layer below.
+ */
+void NNConv2D_backward(NNConv2D *conv, const double *gradOutput) {
+    size_t patch = (size_t)conv->inChannels * conv->kernelSize * conv->kernelSize;
+    size_t pixels = (size_t)conv->outRows * conv->outCols;
+
+    for (size_t i = 0; i < conv->outChannels * pixels; i++) {
+        conv->delta[i] = gradOutput[i] * conv->activationDerivative(conv->output[i]);
+    }
+
+    memset(conv->gradColumns, 0, sizeof(double) * patch * pixels);
+    for (unsigned int oc = 0; oc < conv->outChannels; oc++) {
+        const double *restrict delta = conv->delta + oc * pixels;
+        const double *w = conv->weights + oc * patch;
+        double *gw = conv->gradWeights + oc * patch;
+        double biasSum = 0.0;
+        for (size_t p = 0; p < pixels; p++) {
+            biasSum += delta[p];
+        }
+        conv->gradBiases[oc] += biasSum;
+
+        for (size_t r = 0; r < patch; r++) {
+            const double *restrict col = conv->columns + r * pixels;
+            double *restrict gcol = conv->gradColumns + r * pixels;
+            double weight = w[r];
+            double sum = 0.0;
+            for (size_t p = 0; p < pixels; p++) {
+                sum += delta[p] * col[p];
+                gcol[p] += weight * delta[p];
+            }
+            gw[r] += sum;
+        }
+    }
+
+    col2im(conv);
+}
+
+void NNConv2D_update(NNConv2D *conv, double scale) {
+    double step = -conv->learningRate * scale;
+    for (unsigned int i = 0; i < conv->numWeights; i++) {
+        conv->weights[i] += step * conv->gradWeights[i];
+        conv->gradWeights[i] = 0.0;
+    }
+    for (unsigned int i = 0; i < conv->outChannels; i++) {
+        conv->biases[i] += step * conv->gradBiases[i];
+        conv->gradBiases[i] = 0.0;
+    }
+}
+
+NNPool2D *NNPool2D_create(NNPoolKind kind, unsigned int channels, unsigned int inRows, unsigned int inCols, unsigned int size, unsigned int stride) {
+    if (size != 0 && (stride == 0 || size > inRows || size > inCols)) {
+        fprintf(stderr, "Invalid Pool2D geometry\n");
+        return NULL;
+    }
+
+    NNPool2D *pool = (NNPool2D *)calloc(1, sizeof(NNPool2D));
+    if (!pool) return NULL;
+
+    pool->kind = kind;
+    pool->channels = channels;
+    pool->inRows = inRows;
+    pool->inCols = inCols;
+    pool->size = size;
+    pool->stride = stride;
+    pool->outRows = size == 0 ? 1 : (inRows - size) / stride + 1;
+    pool->outCols = size == 0 ? 1 : (inCols - size) / stride + 1;
+
+    size_t outSize = (size_t)channels * pool->outRows * pool->outCols;
+    pool->output = (double *)calloc(outSize, sizeof(double));
+    pool->argmax = (unsigned int *)calloc(outSize, sizeof(unsigned int));
+    pool->gradInput = (double *)calloc((size_t)channels * inRows * inCols, sizeof(double));
+    if (!pool->output || !pool->argmax || !pool->gradInput) {
+        fprintf(stderr, "Failed to allocate Pool2D layer\n");
+        NNPool2D_destroy(pool);
+        return NULL;
+    }
+    return pool;
+}
+
+void NNPool2D_destroy(NNPool2D *pool) {
+    if (!pool) return;
+    free(pool->output);
+    free(pool->argmax);
+    free(pool->gradInput);
+    free(pool);
+}
+
+unsigned int NNPool2D_output_size(const NNPool2D *pool) {
+    return pool->channels * pool->outRows * pool->outCols;
+}
+
+void NNPool2D_forward(NNPool2D *pool, const double *input) {
+    unsigned int winRows = pool->size ? pool->size : pool->inRows;
+    unsigned int winCols = pool->size ? pool->size : pool->inCols;
+    unsigned int stride = pool->size ? pool->stride : 1;
+    double area = (double)winRows * winCols;
+
+    for (unsigned int c = 0; c < pool->channels; c++) {
+        const double *plane = input + (size_t)c * pool->inRows * pool->inCols;
+        for (unsigned int oy = 0; oy < pool->outRows; oy++) {
+            for (unsigned int ox = 0; ox < pool->outCols; ox++) {
+                size_t out = ((size_t)c * pool->outRows + oy) * pool->outCols + ox;
+                double best = -DBL_MAX;
+                double sum = 0.0;
+                unsigned int bestIndex = 0;
+                for (unsigned int wy = 0; wy < winRows; wy++) {
+                    size_t rowStart = (size_t)(oy * stride + wy) * pool->inCols + ox * stride;
+                    for (unsigned int wx = 0; wx < winCols; wx++) {
+                        double v = plane[rowStart + wx];
+                        sum += v;
+                        if (v > best) {
+                            best = v;
+                            bestIndex = (unsigned int)(rowStart + wx);
+                        }
+                    }
+                }
+                pool->argmax[out] = bestIndex;
+                pool->output[out] = pool->kind == NN_POOL_MAX ? best : sum / area;
+            }
+        }
+    }
+}
+
+void NNPool2D_backward(NNPool2D *pool, const double *gradOutput) {
+    unsigned int winRows = pool->size ? pool->size : pool->inRows;
+    unsigned int winCols = pool->size ? pool->size : pool->inCols;
+    unsigned int stride = pool->size ? pool->stride : 1;
+    double share = 1.0 / ((double)winRows * winCols);
+
+    memset(pool->gradInput, 0, sizeof(double) * pool->channels * pool->inRows * pool->inCols);
+    for (unsigned int c = 0; c < pool->channels; c++) {
+        double *plane = pool->gradInput + (size_t)c * pool->inRows * pool->inCols;
+        for (unsigned int oy = 0; oy < pool->outRows; oy++) {
+            for (unsigned int ox = 0; ox < pool->outCols; ox++) {
+                size_t out = ((size_t)c * pool->outRows + oy) * pool->outCols + ox;
+                if (pool->kind == NN_POOL_MAX) {
+                    plane[pool->argmax[out]] += gradOutput[out];
+                    continue;
+                }
+                double g = gradOutput[out] * share;
+                for (unsigned int wy = 0; wy < winRows; wy++) {
+                    double *row = plane + (size_t)(oy * stride + wy) * pool->inCols + ox * stride;
+                    for (unsigned int wx = 0; wx < winCols; wx++) {
+                        row[wx] += g;
+                    }
+                }
+            }
+        }
+    }
+}
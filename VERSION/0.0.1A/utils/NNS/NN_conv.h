@@ -0,0 +1,72 @@
+#ifndef NN_CONV_H
+#define NN_CONV_H
+
+#include "NN.h"
+
+/*
+ * Grid layers for feeding 2D observations into an NN_t. Tensors are
+ * channel-major: [channels][rows][cols]. Conv2D lowers its input with im2col
+ * and runs one GEMM whose inner loop walks output pixels contiguously, so the
+ * parameter count only depends on channels and kernel size.
+ */
+typedef struct {
+  unsigned int inChannels;
+  unsigned int inRows;
+  unsigned int inCols;
+  unsigned int outChannels;
+  unsigned int kernelSize;
+  unsigned int stride;
+  unsigned int padding;
+  unsigned int outRows;
+  unsigned int outCols;
+  unsigned int numWeights;
+  double *weights;
+  double *biases;
+  double *gradWeights;
+  double *gradBiases;
+  double *columns;
+  double *gradColumns;
+  double *output;
+  double *delta;
+  double *gradInput;
+  double learningRate;
+  ActivationFunction activation;
+  ActivationFunction activationDerivative;
+} NNConv2D;
+
+typedef enum {
+  NN_POOL_MAX,
+  NN_POOL_AVG
+} NNPoolKind;
+
+/* size == 0 pools each channel down to a single value (global pooling). */
+typedef struct {
+  NNPoolKind kind;
+  unsigned int channels;
+  unsigned int inRows;
+  unsigned int inCols;
+  unsigned int size;
+  unsigned int stride;
+  unsigned int outRows;
+  unsigned int outCols;
+  double *output;
+  double *gradInput;
+  unsigned int *argmax;
+} NNPool2D;
+
+NNConv2D *NNConv2D_create(unsigned int inChannels, unsigned int inRows, unsigned int inCols,
+                          unsigned int outChannels, unsigned int kernelSize, unsigned int stride, unsigned int padding,
+                          ActivationFunction activation, ActivationFunction activationDerivative, double learningRate);
+void NNConv2D_destroy(NNConv2D *conv);
+unsigned int NNConv2D_output_size(const NNConv2D *conv);
+void NNConv2D_forward(NNConv2D *conv, const double *input);
+void NNConv2D_backward(NNConv2D *conv, const double *gradOutput);
+void NNConv2D_update(NNConv2D *conv, double scale);
+
+NNPool2D *NNPool2D_create(NNPoolKind kind, unsigned int channels, unsigned int inRows, unsigned int inCols, unsigned int size, unsigned int stride);
+void NNPool2D_destroy(NNPool2D *pool);
+unsigned int NNPool2D_output_size(const NNPool2D *pool);
+void NNPool2D_forward(NNPool2D *pool, const double *input);
+void NNPool2D_backward(NNPool2D *pool, const double *gradOutput);
+
+#endif
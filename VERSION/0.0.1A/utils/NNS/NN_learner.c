@@ -0,0 +1,181 @@
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "NN_learner.h"
+
+#define NN_LEARNER_FRESH 4u
+
+NNLearner *NNLearner_create(NN_t *nn, const NNLearnerConfig *config, uint64_t seed) {
+    if (!nn || !config || config->capacity == 0 || config->batchSize == 0) return NULL;
+
+    NNLearner *learner = (NNLearner *)calloc(1, sizeof(NNLearner));
+    if (!learner) return NULL;
+
+    learner->nn = nn;
+    learner->config = *config;
+    if (learner->config.trainEvery == 0) learner->config.trainEvery = 1;
+    if (learner->config.publishEvery == 0) learner->config.publishEvery = 1;
+    learner->transitionSize = 2 * (size_t)nn->numInputs + 3;
+    learner->queue = ringBufferCreate(config->queueCapacity, sizeof(double) * learner->transitionSize);
+    learner->memory = (double *)malloc(sizeof(double) * learner->transitionSize * config->capacity);
+    learner->incoming = (double *)malloc(sizeof(double) * learner->transitionSize);
+    learner->grad = (double *)calloc(nn->numParams, sizeof(double));
+    learner->scratch = (double *)calloc(2 * (nn->numHidden + nn->numOutput) + nn->numOutput, sizeof(double));
+    for (int i = 0; i < 3; i++) {
+        learner->buffers[i] = (double *)malloc(sizeof(double) * nn->numParams);
+    }
+    if (!learner->queue || !learner->memory || !learner->incoming || !learner->grad || !learner->scratch ||
+        !learner->buffers[0] || !learner->buffers[1] || !learner->buffers[2]) {
+        fprintf(stderr, "Failed to allocate learner\n");
+        learner->nn = NULL;
+        NNLearner_destroy(learner);
+        return NULL;
+    }
+
+    NN_set_loss(nn, NN_LOSS_MSE);
+    for (int i = 0; i < 3; i++) {
+        memcpy(learner->buffers[i], nn->params, sizeof(double) * nn->numParams);
+    }
+    learner->front = 0;
+    learner->back = 2;
+    atomic_init(&learner->middle, 1u);
+    atomic_init(&learner->stop, 0);
+    atomic_init(&learner->steps, 0);
+    atomic_init(&learner->dropped, 0);
+    rngSeed(&learner->rng, seed, 0);
+    return learner;
+}
+
+void NNLearner_destroy(NNLearner *learner) {
+    if (!learner) return;
+    NNLearner_stop(learner);
+    ringBufferDestroy(learner->queue);
+    free(learner->memory);
+    free(learner->incoming);
+    free(learner->grad);
+    free(learner->scratch);
+    for (int i = 0; i < 3; i++) {
+        free(learner->buffers[i]);
+    }
+    NN_destroy(learner->nn);
+    free(learner);
+}
+
+/* Returns 0, or -1 when the learner is behind and the transition was dropped. */
+int NNLearner_push(NNLearner *learner, const double *observation, unsigned int action, double reward, const double *next, int done) {
+    unsigned int n = learner->nn->numInputs;
+    double record[learner->transitionSize];
+    memcpy(record, observation, sizeof(double) * n);
+    memcpy(record + n, next, sizeof(double) * n);
+    record[2 * n] = action;
+    record[2 * n + 1] = reward;
+    record[2 * n + 2] = done ? 1 : 0;
+    if (ringBufferPush(learner->queue, record) != 0) {
+        atomic_fetch_add_explicit(&learner->dropped, 1, memory_order_relaxed);
+        return -1;
+    }
+    return 0;
+}
+
+/* Latest published parameters; stays valid until the next acquire. */
+const double *NNLearner_acquire(NNLearner *learner) {
+    if (atomic_load_explicit(&learner->middle, memory_order_relaxed) & NN_LEARNER_FRESH) {
+        unsigned int previous = atomic_exchange_explicit(&learner->middle, learner->front, memory_order_acq_rel);
+        learner->front = previous & ~NN_LEARNER_FRESH;
+    }
+    return learner->buffers[learner->front];
+}
+
+void NNLearner_infer(const NNLearner *learner, const double *params, const double *input, double *hidden, double *output) {
+    const NN_t *nn = learner->nn;
+    const double *biases = params + nn->numWeights;
+    NN_dense(params, biases, input, hidden, nn->numHidden, nn->numInputs);
+    for (unsigned int i = 0; i < nn->numHidden; i++) {
+        hidden[i] = nn->hiddenActivations[i](hidden[i]);
+    }
+    NN_dense(params + (size_t)nn->numInputs * nn->numHidden, biases + nn->numHidden, hidden, output, nn->numOutput, nn->numHidden);
+    for (unsigned int i = 0; i < nn->numOutput; i++) {
+        output[i] = nn->outputActivations[i](output[i]);
+    }
+}
+
+static size_t drain(NNLearner *learner) {
+    size_t drained = 0;
+    while (ringBufferPop(learner->queue, learner->incoming)) {
+        memcpy(learner->memory + learner->next * learner->transitionSize, learner->incoming, sizeof(double) * learner->transitionSize);
+        learner->next = (learner->next + 1) % learner->config.capacity;
+        if (learner->size < learner->config.capacity) learner->size++;
+        drained++;
+    }
+    return drained;
+}
+
+static void trainBatch(NNLearner *learner) {
+    NN_t *nn = learner->nn;
+    unsigned int n = nn->numInputs;
+    double *hidden = learner->scratch;
+    double *output = hidden + nn->numHidden;
+    double *target = output + nn->numOutput;
+    double *errors = target + nn->numOutput;
+
+    memset(learner->grad, 0, sizeof(double) * nn->numParams);
+    for (unsigned int b = 0; b < learner->config.batchSize; b++) {
+        const double *t = learner->memory + rngBelow(&learner->rng, (uint32_t)learner->size) * learner->transitionSize;
+        unsigned int action = (unsigned int)t[2 * n];
+        double value = t[2 * n + 1];
+        if (t[2 * n + 2] == 0) {
+            NN_infer(nn, t + n, hidden, output);
+            value += learner->config.gamma * output[NN_argmax(output, nn->numOutput)];
+        }
+
+        NN_infer(nn, t, hidden, output);
+        memcpy(target, output, sizeof(double) * nn->numOutput);
+        target[action < nn->numOutput ? action : 0] = value;
+        NN_backward(nn, t, hidden, output, target, errors, learner->grad, 1);
+    }
+    NN_apply_gradients(nn, learner->grad, 1.0 / learner->config.batchSize);
+}
+
+static void publish(NNLearner *learner) {
+    memcpy(learner->buffers[learner->back], learner->nn->params, sizeof(double) * learner->nn->numParams);
+    unsigned int previous = atomic_exchange_explicit(&learner->middle, learner->back | NN_LEARNER_FRESH, memory_order_acq_rel);
+    learner->back = previous & ~NN_LEARNER_FRESH;
+}
+
+static void *learnerMain(void *arg) {
+    NNLearner *learner = (NNLearner *)arg;
+    size_t pending = 0;
+    struct timespec idle = {0, 1000000};
+    while (!atomic_load_explicit(&learner->stop, memory_order_relaxed)) {
+        pending += drain(learner);
+        if (learner->size < learner->config.batchSize || pending < learner->config.trainEvery) {
+            nanosleep(&idle, NULL);
+            continue;
+        }
+        pending -= learner->config.trainEvery;
+        trainBatch(learner);
+        size_t steps = atomic_fetch_add_explicit(&learner->steps, 1, memory_order_relaxed) + 1;
+        if (steps % learner->config.publishEvery == 0) {
+            publish(learner);
+        }
+    }
+    return NULL;
+}
+
+int NNLearner_start(NNLearner *learner) {
+    if (learner->started) return 0;
+    atomic_store(&learner->stop, 0);
+    if (pthread_create(&learner->thread, NULL, learnerMain, learner) != 0) {
+        fprintf(stderr, "Failed to start learner thread\n");
+        return -1;
+    }
+    learner->started = 1;
+    return 0;
+}
+
+void NNLearner_stop(NNLearner *learner) {
+    if (!learner->started) return;
+    atomic_store(&learner->stop, 1);
+    pthread_join(learner->thread, NULL);
+    learner->started = 0;
+}
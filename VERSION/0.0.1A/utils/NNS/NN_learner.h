@@ -0,0 +1,61 @@
+#ifndef NN_LEARNER_H
+#define NN_LEARNER_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include "NN.h"
+#include "../Random/rng.h"
+#include "../Concurrency/ring_buffer.h"
+
+typedef struct {
+  size_t capacity;            /* transitions kept for sampling */
+  size_t queueCapacity;       /* transitions in flight to the learner */
+  unsigned int batchSize;
+  unsigned int trainEvery;    /* new transitions per gradient step */
+  unsigned int publishEvery;  /* gradient steps per published snapshot */
+  double gamma;
+} NNLearnerConfig;
+
+/*
+ * Off-thread Q-learning for a network the caller acts with. Actors push
+ * (observation, action, reward, next observation, done) transitions into a
+ * lock-free queue; the learner thread drains it into a replay memory,
+ * trains the network on sampled minibatches with one-step TD targets, and
+ * publishes parameter snapshots through a triple buffer whose buffer
+ * indices are swapped atomically, so neither side ever waits on the other.
+ * Only one thread may call NNLearner_acquire.
+ */
+typedef struct {
+  NN_t *nn;                   /* owned; trained by the learner thread only */
+  NNLearnerConfig config;
+  RingBuffer *queue;
+  size_t transitionSize;      /* doubles: observation | next | action, reward, done */
+  double *memory;
+  size_t size;
+  size_t next;
+  double *incoming;
+  double *grad;
+  double *scratch;
+  double *buffers[3];
+  _Atomic unsigned int middle;
+  unsigned int back;          /* learner thread */
+  unsigned int front;         /* acquiring thread */
+  Rng rng;
+  pthread_t thread;
+  int started;
+  atomic_int stop;
+  atomic_size_t steps;
+  atomic_size_t dropped;
+} NNLearner;
+
+NNLearner *NNLearner_create(NN_t *nn, const NNLearnerConfig *config, uint64_t seed);
+void NNLearner_destroy(NNLearner *learner);
+
+int NNLearner_start(NNLearner *learner);
+void NNLearner_stop(NNLearner *learner);
+
+int NNLearner_push(NNLearner *learner, const double *observation, unsigned int action, double reward, const double *next, int done);
+const double *NNLearner_acquire(NNLearner *learner);
+void NNLearner_infer(const NNLearner *learner, const double *params, const double *input, double *hidden, double *output);
+
+#endif
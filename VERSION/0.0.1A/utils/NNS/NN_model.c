@@ -0,0 +1,335 @@
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "NN_model.h"
+#include "../Hash/fnv1a.h"
+
+uint64_t NN_model_checksum(const void *data, size_t size) {
+    return fnv1a(data, size);
+}
+
+NNActivationKind NN_activation_kind(ActivationFunction f) {
+    if (f == sigmoid) return NN_ACT_SIGMOID;
+    if (f == relu) return NN_ACT_RELU;
+    if (f == tanh_activation) return NN_ACT_TANH;
+    if (f == linear) return NN_ACT_LINEAR;
+    return NN_ACT_UNKNOWN;
+}
+
+static NNActivationKind activation_kind32(ActivationFunction32 f) {
+    if (f == sigmoid32) return NN_ACT_SIGMOID;
+    if (f == relu32) return NN_ACT_RELU;
+    if (f == tanh_activation32) return NN_ACT_TANH;
+    if (f == linear32) return NN_ACT_LINEAR;
+    return NN_ACT_UNKNOWN;
+}
+
+static int activation_from_kind(uint8_t kind, ActivationFunction *f, ActivationFunction *d) {
+    switch (kind) {
+    case NN_ACT_SIGMOID: *f = sigmoid; *d = sigmoid_derivative; return 1;
+    case NN_ACT_RELU: *f = relu; *d = relu_derivative; return 1;
+    case NN_ACT_TANH: *f = tanh_activation; *d = tanh_derivative; return 1;
+    case NN_ACT_LINEAR: *f = linear; *d = linear_derivative; return 1;
+    default: return 0;
+    }
+}
+
+static int activation_from_kind32(uint8_t kind, ActivationFunction32 *f, ActivationFunction32 *d) {
+    switch (kind) {
+    case NN_ACT_SIGMOID: *f = sigmoid32; *d = sigmoid_derivative32; return 1;
+    case NN_ACT_RELU: *f = relu32; *d = relu_derivative32; return 1;
+    case NN_ACT_TANH: *f = tanh_activation32; *d = tanh_derivative32; return 1;
+    case NN_ACT_LINEAR: *f = linear32; *d = linear_derivative32; return 1;
+    default: return 0;
+    }
+}
+
+static int write_model(const char *path, NNModelHeader *header, const uint8_t *kinds, const void *params) {
+    size_t numKinds = header->numHidden + header->numOutput;
+    size_t headerBytes = sizeof(NNModelHeader) + numKinds;
+
+    memcpy(header->magic, NN_MODEL_MAGIC, sizeof(header->magic));
+    header->version = NN_MODEL_VERSION;
+    header->byteOrder = NN_MODEL_BYTE_ORDER;
+    header->paramsOffset = (headerBytes + NN_MODEL_ALIGN - 1) / NN_MODEL_ALIGN * NN_MODEL_ALIGN;
+    header->checksum = NN_model_checksum(params, header->paramsBytes);
+
+    size_t tmpLen = strlen(path) + 5;
+    char *tmpPath = (char *)malloc(tmpLen);
+    if (!tmpPath) return -1;
+    snprintf(tmpPath, tmpLen, "%s.tmp", path);
+
+    FILE *file = fopen(tmpPath, "wb");
+    if (!file) {
+        perror("Failed to open model file");
+        free(tmpPath);
+        return -1;
+    }
+
+    static const char zeros[4096];
+    int ok = fwrite(header, sizeof(NNModelHeader), 1, file) == 1 &&
+             fwrite(kinds, 1, numKinds, file) == numKinds;
+    for (size_t pos = headerBytes; ok && pos < header->paramsOffset;) {
+        size_t chunk = header->paramsOffset - pos < sizeof(zeros) ? header->paramsOffset - pos : sizeof(zeros);
+        ok = fwrite(zeros, 1, chunk, file) == chunk;
+        pos += chunk;
+    }
+    ok = ok && fwrite(params, 1, header->paramsBytes, file) == header->paramsBytes;
+    ok = ok && fflush(file) == 0 && fsync(fileno(file)) == 0;
+    ok = (fclose(file) == 0) && ok;
+
+    if (!ok || rename(tmpPath, path) != 0) {
+        perror("Failed to write model file");
+        unlink(tmpPath);
+        free(tmpPath);
+        return -1;
+    }
+    free(tmpPath);
+    return 0;
+}
+
+int NN_save(NN_t *nn, const char *path) {
+    uint8_t *kinds = (uint8_t *)malloc(nn->numHidden + nn->numOutput);
+    if (!kinds) return -1;
+    for (unsigned int i = 0; i < nn->numHidden; i++) {
+        kinds[i] = (uint8_t)NN_activation_kind(nn->hiddenActivations[i]);
+    }
+    for (unsigned int i = 0; i < nn->numOutput; i++) {
+        kinds[nn->numHidden + i] = (uint8_t)NN_activation_kind(nn->outputActivations[i]);
+    }
+    for (unsigned int i = 0; i < nn->numHidden + nn->numOutput; i++) {
+        if (kinds[i] == NN_ACT_UNKNOWN) {
+            fprintf(stderr, "Cannot save model: neuron %u uses an unregistered activation\n", i);
+            free(kinds);
+            return -1;
+        }
+    }
+
+    NNModelHeader header = {0};
+    header.dtype = NN_DTYPE_FLOAT64;
+    header.numInputs = nn->numInputs;
+    header.numHidden = nn->numHidden;
+    header.numOutput = nn->numOutput;
+    header.numParams = nn->numParams;
+    header.paramsBytes = (uint64_t)nn->numParams * sizeof(double);
+    header.learningRate = nn->learningRate;
+    header.momentum = nn->momentum;
+    header.loss = nn->loss;
+
+    int result = write_model(path, &header, kinds, nn->params);
+    free(kinds);
+    return result;
+}
+
+int NN32_save(NN32_t *nn, const char *path) {
+    uint8_t *kinds = (uint8_t *)malloc(nn->numHidden + nn->numOutput);
+    if (!kinds) return -1;
+    for (unsigned int i = 0; i < nn->numHidden; i++) {
+        kinds[i] = (uint8_t)activation_kind32(nn->hiddenActivations[i]);
+    }
+    for (unsigned int i = 0; i < nn->numOutput; i++) {
+        kinds[nn->numHidden + i] = (uint8_t)activation_kind32(nn->outputActivations[i]);
+    }
+    for (unsigned int i = 0; i < nn->numHidden + nn->numOutput; i++) {
+        if (kinds[i] == NN_ACT_UNKNOWN) {
+            fprintf(stderr, "Cannot save model: neuron %u uses an unregistered activation\n", i);
+            free(kinds);
+            return -1;
+        }
+    }
+
+    NNModelHeader header = {0};
+    header.dtype = NN_DTYPE_FLOAT32;
+    header.numInputs = nn->numInputs;
+    header.numHidden = nn->numHidden;
+    header.numOutput = nn->numOutput;
+    header.numParams = nn->numParams;
+    header.paramsBytes = (uint64_t)nn->numParams * sizeof(float);
+    header.learningRate = nn->learningRate;
+    header.momentum = nn->momentum;
+    header.loss = nn->loss;
+
+    int result = write_model(path, &header, kinds, nn->params);
+    free(kinds);
+    return result;
+}
+
+static int valid_header(const NNModelHeader *header, size_t fileSize) {
+    if (memcmp(header->magic, NN_MODEL_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != NN_MODEL_VERSION || header->byteOrder != NN_MODEL_BYTE_ORDER) {
+        return 0;
+    }
+    uint64_t numWeights = (uint64_t)header->numInputs * header->numHidden + (uint64_t)header->numHidden * header->numOutput;
+    uint64_t elementSize = header->dtype == NN_DTYPE_FLOAT32 ? sizeof(float) : sizeof(double);
+    return header->loss <= NN_LOSS_SOFTMAX_CROSS_ENTROPY &&
+           header->numParams == numWeights + header->numHidden + header->numOutput &&
+           header->paramsBytes == header->numParams * elementSize &&
+           header->paramsOffset % NN_MODEL_ALIGN == 0 &&
+           sizeof(NNModelHeader) + header->numHidden + header->numOutput <= header->paramsOffset &&
+           header->paramsOffset + header->paramsBytes <= fileSize;
+}
+
+static const NNModelHeader *map_model(const char *path, uint32_t dtype, int verify, size_t *mappingSize) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        perror("Failed to open model file");
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(NNModelHeader)) {
+        fprintf(stderr, "Model file %s is truncated\n", path);
+        close(fd);
+        return NULL;
+    }
+
+    void *mapping = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        perror("Failed to map model file");
+        return NULL;
+    }
+
+    const NNModelHeader *header = (const NNModelHeader *)mapping;
+    const char *error = NULL;
+    if (!valid_header(header, (size_t)st.st_size)) {
+        error = "bad header";
+    } else if (header->dtype != dtype) {
+        error = "wrong dtype";
+    } else if (verify && NN_model_checksum((const char *)mapping + header->paramsOffset, header->paramsBytes) != header->checksum) {
+        error = "checksum mismatch";
+    }
+    if (error) {
+        fprintf(stderr, "Failed to load model %s: %s\n", path, error);
+        munmap(mapping, (size_t)st.st_size);
+        return NULL;
+    }
+
+    *mappingSize = (size_t)st.st_size;
+    return header;
+}
+
+int NN_model_info(const char *path, NNModelHeader *header) {
+    FILE *file = fopen(path, "rb");
+    if (!file) return -1;
+    int ok = fread(header, sizeof(NNModelHeader), 1, file) == 1;
+    fclose(file);
+    return ok && memcmp(header->magic, NN_MODEL_MAGIC, sizeof(header->magic)) == 0 ? 0 : -1;
+}
+
+NN_t *NN_load(const char *path, int verify) {
+    size_t mappingSize = 0;
+    const NNModelHeader *header = map_model(path, NN_DTYPE_FLOAT64, verify, &mappingSize);
+    if (!header) return NULL;
+
+    const uint8_t *kinds = (const uint8_t *)(header + 1);
+    NN_t *nn = (NN_t *)calloc(1, sizeof(NN_t));
+    if (!nn) {
+        munmap((void *)header, mappingSize);
+        return NULL;
+    }
+
+    nn->mapping = (void *)header;
+    nn->mappingSize = mappingSize;
+    nn->numInputs = header->numInputs;
+    nn->numHidden = header->numHidden;
+    nn->numOutput = header->numOutput;
+    nn->numWeights = nn->numInputs * nn->numHidden + nn->numHidden * nn->numOutput;
+    nn->numBiases = nn->numHidden + nn->numOutput;
+    nn->numParams = (unsigned int)header->numParams;
+    nn->params = (double *)((char *)nn->mapping + header->paramsOffset);
+    nn->weights = nn->params;
+    nn->biases = nn->params + nn->numWeights;
+    nn->learningRate = header->learningRate;
+    nn->momentum = header->momentum;
+
+    nn->inputs = (double *)calloc(nn->numInputs, sizeof(double));
+    nn->hidden = (double *)calloc(nn->numHidden, sizeof(double));
+    nn->output = (double *)calloc(nn->numOutput, sizeof(double));
+    nn->workspace = (double *)calloc(NN_workspace_size(nn), sizeof(double));
+    nn->hiddenActivations = (ActivationFunction *)malloc(nn->numHidden * sizeof(ActivationFunction));
+    nn->hiddenActivationDerivatives = (ActivationFunction *)malloc(nn->numHidden * sizeof(ActivationFunction));
+    nn->outputActivations = (ActivationFunction *)malloc(nn->numOutput * sizeof(ActivationFunction));
+    nn->outputActivationDerivatives = (ActivationFunction *)malloc(nn->numOutput * sizeof(ActivationFunction));
+    if (!nn->inputs || !nn->hidden || !nn->output || !nn->workspace ||
+        !nn->hiddenActivations || !nn->hiddenActivationDerivatives || !nn->outputActivations || !nn->outputActivationDerivatives) {
+        NN_destroy(nn);
+        return NULL;
+    }
+
+    int ok = 1;
+    for (unsigned int i = 0; i < nn->numHidden; i++) {
+        ok &= activation_from_kind(kinds[i], &nn->hiddenActivations[i], &nn->hiddenActivationDerivatives[i]);
+    }
+    for (unsigned int i = 0; i < nn->numOutput; i++) {
+        ok &= activation_from_kind(kinds[nn->numHidden + i], &nn->outputActivations[i], &nn->outputActivationDerivatives[i]);
+    }
+    if (!ok) {
+        fprintf(stderr, "Failed to load model %s: unknown activation kind\n", path);
+        NN_destroy(nn);
+        return NULL;
+    }
+    nn->loss = (NNLoss)header->loss;
+
+    return nn;
+}
+
+NN32_t *NN32_load(const char *path, int verify) {
+    size_t mappingSize = 0;
+    const NNModelHeader *header = map_model(path, NN_DTYPE_FLOAT32, verify, &mappingSize);
+    if (!header) return NULL;
+
+    const uint8_t *kinds = (const uint8_t *)(header + 1);
+    NN32_t *nn = (NN32_t *)calloc(1, sizeof(NN32_t));
+    if (!nn) {
+        munmap((void *)header, mappingSize);
+        return NULL;
+    }
+
+    nn->mapping = (void *)header;
+    nn->mappingSize = mappingSize;
+    nn->numInputs = header->numInputs;
+    nn->numHidden = header->numHidden;
+    nn->numOutput = header->numOutput;
+    nn->numWeights = nn->numInputs * nn->numHidden + nn->numHidden * nn->numOutput;
+    nn->numBiases = nn->numHidden + nn->numOutput;
+    nn->numParams = (unsigned int)header->numParams;
+    nn->params = (float *)((char *)nn->mapping + header->paramsOffset);
+    nn->weights = nn->params;
+    nn->biases = nn->params + nn->numWeights;
+    nn->learningRate = (float)header->learningRate;
+    nn->momentum = (float)header->momentum;
+
+    nn->inputs = (float *)calloc(nn->numInputs, sizeof(float));
+    nn->hidden = (float *)calloc(nn->numHidden, sizeof(float));
+    nn->output = (float *)calloc(nn->numOutput, sizeof(float));
+    nn->workspace = (float *)calloc(NN32_workspace_size(nn), sizeof(float));
+    nn->hiddenActivations = (ActivationFunction32 *)malloc(nn->numHidden * sizeof(ActivationFunction32));
+    nn->hiddenActivationDerivatives = (ActivationFunction32 *)malloc(nn->numHidden * sizeof(ActivationFunction32));
+    nn->outputActivations = (ActivationFunction32 *)malloc(nn->numOutput * sizeof(ActivationFunction32));
+    nn->outputActivationDerivatives = (ActivationFunction32 *)malloc(nn->numOutput * sizeof(ActivationFunction32));
+    if (!nn->inputs || !nn->hidden || !nn->output || !nn->workspace ||
+        !nn->hiddenActivations || !nn->hiddenActivationDerivatives || !nn->outputActivations || !nn->outputActivationDerivatives) {
+        NN32_destroy(nn);
+        return NULL;
+    }
+
+    int ok = 1;
+    for (unsigned int i = 0; i < nn->numHidden; i++) {
+        ok &= activation_from_kind32(kinds[i], &nn->hiddenActivations[i], &nn->hiddenActivationDerivatives[i]);
+    }
+    for (unsigned int i = 0; i < nn->numOutput; i++) {
+        ok &= activation_from_kind32(kinds[nn->numHidden + i], &nn->outputActivations[i], &nn->outputActivationDerivatives[i]);
+    }
+    if (!ok) {
+        fprintf(stderr, "Failed to load model %s: unknown activation kind\n", path);
+        NN32_destroy(nn);
+        return NULL;
+    }
+    nn->loss = (NNLoss)header->loss;
+
+    return nn;
+}
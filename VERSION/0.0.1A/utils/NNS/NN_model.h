@@ -0,0 +1,66 @@
+#ifndef NN_MODEL_H
+#define NN_MODEL_H
+
+#include <stdint.h>
+#include "NN.h"
+
+/*
+ * Binary model file:
+ *   NNModelHeader | activation kinds (uint8, hidden then output) | zero pad |
+ *   params blob at paramsOffset (a multiple of NN_MODEL_ALIGN)
+ * The blob is the NN_t params block verbatim: weights then biases, in the
+ * element type named by dtype. The checksum is FNV-1a over the blob.
+ *
+ * NN_load/NN32_load map the file read-only and point params straight into
+ * the mapping, so every process that loads the same file shares one
+ * physical copy. Loaded networks do not own their params (ownsParams is 0)
+ * and are for inference only: they have no optimizer state, and backprop
+ * on them faults.
+ */
+#define NN_MODEL_MAGIC "NNMODEL"
+#define NN_MODEL_VERSION 3
+#define NN_MODEL_BYTE_ORDER 0x01020304u
+#define NN_MODEL_ALIGN 16384
+
+typedef enum {
+  NN_DTYPE_FLOAT64 = 0,
+  NN_DTYPE_FLOAT32 = 1
+} NNDType;
+
+typedef enum {
+  NN_ACT_UNKNOWN = 0,
+  NN_ACT_SIGMOID = 1,
+  NN_ACT_RELU = 2,
+  NN_ACT_TANH = 3,
+  NN_ACT_LINEAR = 4
+} NNActivationKind;
+
+typedef struct {
+  char magic[8];
+  uint32_t version;
+  uint32_t byteOrder;
+  uint32_t dtype;
+  uint32_t numInputs;
+  uint32_t numHidden;
+  uint32_t numOutput;
+  uint64_t numParams;
+  uint64_t paramsOffset;
+  uint64_t paramsBytes;
+  uint64_t checksum;
+  double learningRate;
+  double momentum;
+  uint32_t loss;     /* NNLoss */
+  uint32_t reserved;
+} NNModelHeader;
+
+int NN_save(NN_t *nn, const char *path);
+int NN32_save(NN32_t *nn, const char *path);
+
+NN_t *NN_load(const char *path, int verify);
+NN32_t *NN32_load(const char *path, int verify);
+
+int NN_model_info(const char *path, NNModelHeader *header);
+uint64_t NN_model_checksum(const void *data, size_t size);
+NNActivationKind NN_activation_kind(ActivationFunction f);
+
+#endif
@@ -0,0 +1,171 @@
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "NN_parallel.h"
+
+NNParallelTrainer *NNParallel_create(NN_t *nn, int numWorkers, NNParallelMode mode) {
+    if (numWorkers <= 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        numWorkers = online > 0 ? (int)online : 1;
+    }
+
+    if (mode == NN_PARALLEL_HOGWILD && nn->optimizer.kind != NN_SGD) {
+        fprintf(stderr, "Hogwild training needs the SGD optimizer\n");
+        return NULL;
+    }
+
+    NNParallelTrainer *trainer = (NNParallelTrainer *)calloc(1, sizeof(NNParallelTrainer));
+    if (!trainer) return NULL;
+
+    trainer->nn = nn;
+    trainer->numWorkers = (unsigned int)numWorkers;
+    trainer->mode = mode;
+    trainer->numParams = nn->numParams;
+    trainer->grad = (double *)calloc(trainer->numParams, sizeof(double));
+    trainer->workers = (NNParallelWorker *)calloc(numWorkers, sizeof(NNParallelWorker));
+    trainer->pool = threadPoolCreate(numWorkers, numWorkers * 2);
+    if (!trainer->grad || !trainer->workers || !trainer->pool) {
+        fprintf(stderr, "Failed to create parallel trainer\n");
+        NNParallel_destroy(trainer);
+        return NULL;
+    }
+
+    for (int i = 0; i < numWorkers; i++) {
+        NNParallelWorker *worker = &trainer->workers[i];
+        worker->trainer = trainer;
+        worker->id = (unsigned int)i;
+        worker->grad = (double *)calloc(trainer->numParams, sizeof(double));
+        worker->workspace = (double *)calloc(NN_workspace_size(nn), sizeof(double));
+        if (!worker->grad || !worker->workspace) {
+            fprintf(stderr, "Failed to allocate parallel trainer worker\n");
+            NNParallel_destroy(trainer);
+            return NULL;
+        }
+    }
+
+    return trainer;
+}
+
+void NNParallel_destroy(NNParallelTrainer *trainer) {
+    if (!trainer) return;
+    threadPoolDestroy(trainer->pool);
+    if (trainer->workers) {
+        for (unsigned int i = 0; i < trainer->numWorkers; i++) {
+            free(trainer->workers[i].grad);
+            free(trainer->workers[i].workspace);
+        }
+    }
+    free(trainer->workers);
+    free(trainer->grad);
+    free(trainer);
+}
+
+static void shard_gradients(void *arg) {
+    NNParallelWorker *worker = (NNParallelWorker *)arg;
+    NN_t *nn = worker->trainer->nn;
+
+    memset(worker->grad, 0, sizeof(double) * worker->trainer->numParams);
+    worker->error = 0.0;
+    for (int s = worker->begin; s < worker->end; s++) {
+        worker->error += NN_gradients(nn, worker->inputs + (size_t)s * nn->numInputs,
+                                      worker->targets + (size_t)s * nn->numOutput,
+                                      worker->workspace, worker->grad);
+    }
+}
+
+/* All-reduce: worker i owns parameter slice i and sums it across every worker. */
+static void shard_reduce(void *arg) {
+    NNParallelWorker *worker = (NNParallelWorker *)arg;
+    NNParallelTrainer *trainer = worker->trainer;
+    size_t chunk = (trainer->numParams + trainer->numWorkers - 1) / trainer->numWorkers;
+    size_t begin = worker->id * chunk;
+    size_t end = begin + chunk < trainer->numParams ? begin + chunk : trainer->numParams;
+
+    for (size_t i = begin; i < end; i++) {
+        double sum = 0.0;
+        for (unsigned int w = 0; w < trainer->numWorkers; w++) {
+            sum += trainer->workers[w].grad[i];
+        }
+        trainer->grad[i] = sum;
+    }
+}
+
+/*
+ * Hogwild: every worker writes its per-sample step straight into the shared
+ * weights without locking. Races only lose the odd update, which sparse-ish
+ * SGD tolerates, and nothing waits on anything. Only plain SGD is allowed:
+ * the stateful optimizers would race on their moments and step count, so
+ * NNParallel_create rejects them for this mode.
+ */
+static void shard_hogwild(void *arg) {
+    NNParallelWorker *worker = (NNParallelWorker *)arg;
+    NN_t *nn = worker->trainer->nn;
+    double step = -nn->learningRate;
+
+    memset(worker->grad, 0, sizeof(double) * worker->trainer->numParams);
+    worker->error = 0.0;
+    for (int s = worker->begin; s < worker->end; s++) {
+        worker->error += NN_gradients(nn, worker->inputs + (size_t)s * nn->numInputs,
+                                      worker->targets + (size_t)s * nn->numOutput,
+                                      worker->workspace, worker->grad);
+        for (unsigned int i = 0; i < nn->numParams; i++) {
+            nn->params[i] += step * worker->grad[i];
+            worker->grad[i] = 0.0;
+        }
+    }
+}
+
+static void dispatch(NNParallelTrainer *trainer, void (*task)(void *), const double *inputs, const double *targets, int begin, int end) {
+    int count = end - begin;
+    for (unsigned int w = 0; w < trainer->numWorkers; w++) {
+        NNParallelWorker *worker = &trainer->workers[w];
+        worker->inputs = inputs;
+        worker->targets = targets;
+        worker->begin = begin + (int)((long)count * w / trainer->numWorkers);
+        worker->end = begin + (int)((long)count * (w + 1) / trainer->numWorkers);
+        if (!threadPoolAddTask(trainer->pool, task, worker)) {
+            task(worker);
+        }
+    }
+    threadPoolWait(trainer->pool);
+}
+
+static double collect_error(NNParallelTrainer *trainer) {
+    double error = 0.0;
+    for (unsigned int w = 0; w < trainer->numWorkers; w++) {
+        error += trainer->workers[w].error;
+    }
+    return error;
+}
+
+double NNParallel_train(NNParallelTrainer *trainer, double *inputs, double *targets, int num_samples, int batch_size, int num_epochs) {
+    NN_t *nn = trainer->nn;
+    double error = 0.0;
+    if (num_samples <= 0) return error;
+    if (batch_size <= 0 || batch_size > num_samples) batch_size = num_samples;
+    if (trainer->mode == NN_PARALLEL_HOGWILD && nn->optimizer.kind != NN_SGD) {
+        fprintf(stderr, "Hogwild training needs the SGD optimizer\n");
+        return -1.0;
+    }
+
+    for (int epoch = 0; epoch < num_epochs; epoch++) {
+        error = 0.0;
+        if (trainer->mode == NN_PARALLEL_HOGWILD) {
+            dispatch(trainer, shard_hogwild, inputs, targets, 0, num_samples);
+            error = collect_error(trainer);
+        } else {
+            for (int begin = 0; begin < num_samples; begin += batch_size) {
+                int end = begin + batch_size < num_samples ? begin + batch_size : num_samples;
+                dispatch(trainer, shard_gradients, inputs, targets, begin, end);
+                error += collect_error(trainer);
+                dispatch(trainer, shard_reduce, inputs, targets, begin, end);
+                NN_apply_gradients(nn, trainer->grad, 1.0 / (end - begin));
+            }
+        }
+        /* Mean per-sample loss, as train reports it: cross-entropy is already one value per sample. */
+        error /= (double)num_samples * (nn->loss == NN_LOSS_SOFTMAX_CROSS_ENTROPY ? 1 : nn->numOutput);
+        nn->error = error;
+        printf("Epoch %d: Error = %.6f\n", epoch, error);
+    }
+    return error;
+}
@@ -0,0 +1,41 @@
+#ifndef NN_PARALLEL_H
+#define NN_PARALLEL_H
+
+#include "NN.h"
+#include "../Concurrency/thread_pool.h"
+
+typedef enum {
+  NN_PARALLEL_ALLREDUCE,
+  NN_PARALLEL_HOGWILD
+} NNParallelMode;
+
+typedef struct NNParallelTrainer NNParallelTrainer;
+
+typedef struct {
+  NNParallelTrainer *trainer;
+  unsigned int id;
+  double *grad;
+  double *workspace;
+  const double *inputs;
+  const double *targets;
+  int begin;
+  int end;
+  double error;
+} NNParallelWorker;
+
+struct NNParallelTrainer {
+  NN_t *nn;
+  ThreadPool *pool;
+  NNParallelWorker *workers;
+  unsigned int numWorkers;
+  NNParallelMode mode;
+  size_t numParams;
+  double *grad;
+};
+
+NNParallelTrainer *NNParallel_create(NN_t *nn, int numWorkers, NNParallelMode mode);
+void NNParallel_destroy(NNParallelTrainer *trainer);
+
+double NNParallel_train(NNParallelTrainer *trainer, double *inputs, double *targets, int num_samples, int batch_size, int num_epochs);
+
+#endif
@@ -0,0 +1,267 @@
+#include <stdlib.h>
+#include <string.h>
+#include "NN_population.h"
+
+#define NN_POPULATION_ALIGN 64
+
+static int fits(const NNPopulation *pop, NN_t *nn) {
+    if (nn->numInputs != pop->numInputs || nn->numHidden != pop->numHidden || nn->numOutput != pop->numOutput) {
+        return 0;
+    }
+    return memcmp(nn->hiddenActivations, pop->hiddenActivations, pop->numHidden * sizeof(ActivationFunction)) == 0 &&
+           memcmp(nn->outputActivations, pop->outputActivations, pop->numOutput * sizeof(ActivationFunction)) == 0;
+}
+
+/* Points network index at its slot, e.g. after the blocks moved. */
+static void rebind_network(NNPopulation *pop, unsigned int index) {
+    NN_t *nn = pop->networks[index];
+    nn->params = pop->params + index * pop->paramStride;
+    nn->weights = nn->params;
+    nn->biases = nn->params + nn->numWeights;
+    nn->hidden = pop->hidden + (size_t)index * pop->numHidden;
+    nn->output = pop->output + (size_t)index * pop->numOutput;
+}
+
+static void bind_network(NNPopulation *pop, unsigned int index) {
+    NN_t *nn = pop->networks[index];
+    double *slot = pop->params + index * pop->paramStride;
+    double *hidden = pop->hidden + (size_t)index * pop->numHidden;
+    double *output = pop->output + (size_t)index * pop->numOutput;
+
+    memcpy(slot, nn->params, sizeof(double) * nn->numParams);
+    memcpy(hidden, nn->hidden, sizeof(double) * nn->numHidden);
+    memcpy(output, nn->output, sizeof(double) * nn->numOutput);
+    if (nn->ownsParams) {
+        free(nn->params);
+    }
+    free(nn->hidden);
+    free(nn->output);
+    nn->ownsParams = 0;
+    rebind_network(pop, index);
+}
+
+static double *detach_buffer(const double *src, unsigned int n) {
+    double *dst = (double *)malloc(sizeof(double) * n);
+    if (!dst) {
+        fprintf(stderr, "Failed to detach network from population\n");
+        return NULL;
+    }
+    memcpy(dst, src, sizeof(double) * n);
+    return dst;
+}
+
+static void unbind_network(NN_t *nn) {
+    nn->params = detach_buffer(nn->params, nn->numParams);
+    nn->ownsParams = nn->params != NULL;
+    nn->weights = nn->params;
+    nn->biases = nn->params ? nn->params + nn->numWeights : NULL;
+    nn->hidden = detach_buffer(nn->hidden, nn->numHidden);
+    nn->output = detach_buffer(nn->output, nn->numOutput);
+}
+
+static double *alloc_params(size_t count) {
+    void *block = NULL;
+    if (posix_memalign(&block, NN_POPULATION_ALIGN, sizeof(double) * count) != 0) {
+        return NULL;
+    }
+    memset(block, 0, sizeof(double) * count);
+    return (double *)block;
+}
+
+/* Grows every per-member block to hold capacity members; bound networks move with their slots. */
+static int reserve(NNPopulation *pop, unsigned int capacity) {
+    if (capacity <= pop->capacity) return 0;
+
+    double *params = alloc_params(pop->paramStride * capacity);
+    double *nextParams = alloc_params(pop->paramStride * capacity);
+    double *hidden = (double *)calloc((size_t)capacity * pop->numHidden, sizeof(double));
+    double *output = (double *)calloc((size_t)capacity * pop->numOutput, sizeof(double));
+    NN_t **networks = (NN_t **)malloc(sizeof(NN_t *) * capacity);
+    if (!params || !nextParams || !hidden || !output || !networks) {
+        fprintf(stderr, "Failed to grow network population to %u members\n", capacity);
+        free(params);
+        free(nextParams);
+        free(hidden);
+        free(output);
+        free(networks);
+        return -1;
+    }
+
+    if (pop->numNetworks > 0) {
+        memcpy(params, pop->params, sizeof(double) * pop->paramStride * pop->numNetworks);
+        memcpy(hidden, pop->hidden, sizeof(double) * pop->numHidden * pop->numNetworks);
+        memcpy(output, pop->output, sizeof(double) * pop->numOutput * pop->numNetworks);
+        memcpy(networks, pop->networks, sizeof(NN_t *) * pop->numNetworks);
+    }
+    free(pop->params);
+    free(pop->nextParams);
+    free(pop->hidden);
+    free(pop->output);
+    free(pop->networks);
+    pop->params = params;
+    pop->nextParams = nextParams;
+    pop->hidden = hidden;
+    pop->output = output;
+    pop->networks = networks;
+    pop->capacity = capacity;
+
+    for (unsigned int i = 0; i < pop->numNetworks; i++) {
+        rebind_network(pop, i);
+    }
+    return 0;
+}
+
+NNPopulation *NNPopulation_create(NN_t **networks, unsigned int numNetworks) {
+    if (!networks || numNetworks == 0) return NULL;
+
+    NNPopulation *pop = (NNPopulation *)calloc(1, sizeof(NNPopulation));
+    if (!pop) return NULL;
+
+    NN_t *first = networks[0];
+    size_t perDouble = NN_POPULATION_ALIGN / sizeof(double);
+    pop->numInputs = first->numInputs;
+    pop->numHidden = first->numHidden;
+    pop->numOutput = first->numOutput;
+    pop->paramStride = (first->numParams + perDouble - 1) / perDouble * perDouble;
+    pop->hiddenActivations = (ActivationFunction *)malloc(sizeof(ActivationFunction) * pop->numHidden);
+    pop->outputActivations = (ActivationFunction *)malloc(sizeof(ActivationFunction) * pop->numOutput);
+    if (!pop->hiddenActivations || !pop->outputActivations || reserve(pop, numNetworks) != 0) {
+        fprintf(stderr, "Failed to allocate network population\n");
+        NNPopulation_destroy(pop);
+        return NULL;
+    }
+    memcpy(pop->hiddenActivations, first->hiddenActivations, sizeof(ActivationFunction) * pop->numHidden);
+    memcpy(pop->outputActivations, first->outputActivations, sizeof(ActivationFunction) * pop->numOutput);
+
+    for (unsigned int i = 1; i < numNetworks; i++) {
+        if (!fits(pop, networks[i])) {
+            fprintf(stderr, "Population network %u does not match the shape of network 0\n", i);
+            NNPopulation_destroy(pop);
+            return NULL;
+        }
+    }
+
+    memcpy(pop->networks, networks, sizeof(NN_t *) * numNetworks);
+    pop->numNetworks = numNetworks;
+    for (unsigned int i = 0; i < numNetworks; i++) {
+        bind_network(pop, i);
+    }
+
+    return pop;
+}
+
+void NNPopulation_destroy(NNPopulation *pop) {
+    if (!pop) return;
+    for (unsigned int i = 0; i < pop->numNetworks; i++) {
+        unbind_network(pop->networks[i]);
+    }
+    free(pop->params);
+    free(pop->nextParams);
+    free(pop->hidden);
+    free(pop->output);
+    free(pop->networks);
+    free(pop->hiddenActivations);
+    free(pop->outputActivations);
+    free(pop);
+}
+
+/* Binds nn to a new last slot, doubling the blocks when full. Returns 0, or -1 if it does not fit. */
+int NNPopulation_add(NNPopulation *pop, NN_t *nn) {
+    if (!fits(pop, nn)) {
+        fprintf(stderr, "Network does not match the population's shape\n");
+        return -1;
+    }
+    if (pop->numNetworks == pop->capacity && reserve(pop, pop->capacity * 2) != 0) {
+        return -1;
+    }
+    unsigned int index = pop->numNetworks++;
+    pop->networks[index] = nn;
+    bind_network(pop, index);
+    return 0;
+}
+
+/* Hands member index its own buffers back and moves the last member into its slot. */
+void NNPopulation_remove(NNPopulation *pop, unsigned int index) {
+    unbind_network(pop->networks[index]);
+    unsigned int last = --pop->numNetworks;
+    if (index == last) return;
+
+    memcpy(pop->params + index * pop->paramStride, pop->params + last * pop->paramStride, sizeof(double) * pop->paramStride);
+    memcpy(pop->hidden + (size_t)index * pop->numHidden, pop->hidden + (size_t)last * pop->numHidden, sizeof(double) * pop->numHidden);
+    memcpy(pop->output + (size_t)index * pop->numOutput, pop->output + (size_t)last * pop->numOutput, sizeof(double) * pop->numOutput);
+    pop->networks[index] = pop->networks[last];
+    rebind_network(pop, index);
+}
+
+void NNPopulation_swap(NNPopulation *pop) {
+    double *params = pop->nextParams;
+    pop->nextParams = pop->params;
+    pop->params = params;
+    for (unsigned int i = 0; i < pop->numNetworks; i++) {
+        NN_t *nn = pop->networks[i];
+        nn->params = params + i * pop->paramStride;
+        nn->weights = nn->params;
+        nn->biases = nn->params + nn->numWeights;
+    }
+}
+
+/*
+ * inputs for network i start at inputs + i * inputStride; a stride of 0 feeds
+ * every member the same observation.
+ */
+void NNPopulation_forward(NNPopulation *pop, const double *inputs, size_t inputStride) {
+    NNPopulation_forward_range(pop, 0, pop->numNetworks, inputs, inputStride);
+}
+
+/* Members [first, first + count) only; disjoint ranges may run on different threads. */
+void NNPopulation_forward_range(NNPopulation *pop, unsigned int first, unsigned int count, const double *inputs, size_t inputStride) {
+    unsigned int numInputs = pop->numInputs;
+    unsigned int numHidden = pop->numHidden;
+    unsigned int numOutput = pop->numOutput;
+    size_t weightsIH = (size_t)numInputs * numHidden;
+    size_t numWeights = weightsIH + (size_t)numHidden * numOutput;
+
+    for (unsigned int n = first; n < first + count; n++) {
+        const double *x = inputs + n * inputStride;
+        const double *slot = pop->params + n * pop->paramStride;
+        double *hidden = pop->hidden + (size_t)n * numHidden;
+        double *output = pop->output + (size_t)n * numOutput;
+
+        NN_dense(slot, slot + numWeights, x, hidden, numHidden, numInputs);
+        for (unsigned int i = 0; i < numHidden; i++) {
+            hidden[i] = pop->hiddenActivations[i](hidden[i]);
+        }
+
+        NN_dense(slot + weightsIH, slot + numWeights + numHidden, hidden, output, numOutput, numHidden);
+        for (unsigned int i = 0; i < numOutput; i++) {
+            output[i] = pop->outputActivations[i](output[i]);
+        }
+
+        memcpy(pop->networks[n]->inputs, x, sizeof(double) * numInputs);
+    }
+}
+
+/* Every member sees the same sparse observation; nn->inputs is not filled. */
+void NNPopulation_forward_sparse(NNPopulation *pop, const NNSparseInput *entries, unsigned int count) {
+    unsigned int numInputs = pop->numInputs;
+    unsigned int numHidden = pop->numHidden;
+    unsigned int numOutput = pop->numOutput;
+    size_t weightsIH = (size_t)numInputs * numHidden;
+    size_t numWeights = weightsIH + (size_t)numHidden * numOutput;
+
+    for (unsigned int n = 0; n < pop->numNetworks; n++) {
+        const double *slot = pop->params + n * pop->paramStride;
+        double *hidden = pop->hidden + (size_t)n * numHidden;
+        double *output = pop->output + (size_t)n * numOutput;
+
+        NN_sparse_dense(slot, slot + numWeights, entries, count, hidden, numHidden, numInputs);
+        for (unsigned int i = 0; i < numHidden; i++) {
+            hidden[i] = pop->hiddenActivations[i](hidden[i]);
+        }
+
+        NN_dense(slot + weightsIH, slot + numWeights + numHidden, hidden, output, numOutput, numHidden);
+        for (unsigned int i = 0; i < numOutput; i++) {
+            output[i] = pop->outputActivations[i](output[i]);
+        }
+    }
+}
@@ -0,0 +1,49 @@
+#ifndef NN_POPULATION_H
+#define NN_POPULATION_H
+
+#include "NN.h"
+
+/*
+ * Same-shaped networks stacked into one strided parameter tensor. Creating a
+ * population binds each NN_t to its slot: nn->params (and so weights and
+ * biases), nn->hidden and nn->output point into the population, so backprop,
+ * mutate and crossover keep working on the NN_t while NNPopulation_forward
+ * evaluates every member in one pass. NNPopulation_destroy hands each network its own buffers back,
+ * so it must run before the networks are destroyed. A network loaded from a
+ * model file joins with a writable copy of its params; the file is untouched.
+ *
+ * nextParams is a second tensor with the same layout for breeding: write the
+ * next generation there, then NNPopulation_swap flips the buffers and
+ * rebinds every network to its new slot.
+ *
+ * NNPopulation_add appends a member, doubling the blocks when they are
+ * full, and NNPopulation_remove moves the last member into the freed slot,
+ * so membership changes cost one network's copy, not a rebuild.
+ */
+typedef struct {
+  unsigned int numNetworks;
+  unsigned int capacity;
+  unsigned int numInputs;
+  unsigned int numHidden;
+  unsigned int numOutput;
+  size_t paramStride;
+  double *params;
+  double *nextParams;
+  double *hidden;
+  double *output;
+  NN_t **networks;
+  ActivationFunction *hiddenActivations;
+  ActivationFunction *outputActivations;
+} NNPopulation;
+
+NNPopulation *NNPopulation_create(NN_t **networks, unsigned int numNetworks);
+void NNPopulation_destroy(NNPopulation *pop);
+int NNPopulation_add(NNPopulation *pop, NN_t *nn);
+void NNPopulation_remove(NNPopulation *pop, unsigned int index);
+void NNPopulation_swap(NNPopulation *pop);
+
+void NNPopulation_forward(NNPopulation *pop, const double *inputs, size_t inputStride);
+void NNPopulation_forward_range(NNPopulation *pop, unsigned int first, unsigned int count, const double *inputs, size_t inputStride);
+void NNPopulation_forward_sparse(NNPopulation *pop, const NNSparseInput *entries, unsigned int count);
+
+#endif
@@ -0,0 +1,231 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(__AVX2__) || defined(__SSSE3__)
+#include <immintrin.h>
+#endif
+#include "NN_quant.h"
+
+static unsigned int pad_to_align(unsigned int n) {
+    return (n + NNQ8_ALIGN - 1) / NNQ8_ALIGN * NNQ8_ALIGN;
+}
+
+static int8_t quantize_value(double x, double invScale) {
+    long v = lround(x * invScale);
+    if (v > 127) v = 127;
+    if (v < -127) v = -127;
+    return (int8_t)v;
+}
+
+static float quantize_layer(int8_t *dst, const double *src, unsigned int rows, unsigned int cols, unsigned int stride) {
+    double amax = 0.0;
+    for (size_t i = 0; i < (size_t)rows * cols; i++) {
+        double a = fabs(src[i]);
+        if (a > amax) amax = a;
+    }
+    double scale = amax > 0.0 ? amax / 127.0 : 1.0;
+    double invScale = 1.0 / scale;
+
+    memset(dst, 0, (size_t)rows * stride);
+    for (unsigned int i = 0; i < rows; i++) {
+        for (unsigned int j = 0; j < cols; j++) {
+            dst[(size_t)i * stride + j] = quantize_value(src[(size_t)i * cols + j], invScale);
+        }
+    }
+    return (float)scale;
+}
+
+static double quantize_activations(int8_t *dst, const double *src, unsigned int n) {
+    double amax = 0.0;
+    for (unsigned int i = 0; i < n; i++) {
+        double a = fabs(src[i]);
+        if (a > amax) amax = a;
+    }
+    if (amax == 0.0) {
+        memset(dst, 0, n);
+        return 0.0;
+    }
+    double scale = amax / 127.0;
+    double invScale = 1.0 / scale;
+    for (unsigned int i = 0; i < n; i++) {
+        dst[i] = quantize_value(src[i], invScale);
+    }
+    return scale;
+}
+
+#if defined(__AVX2__)
+static int32_t hsum_epi32(__m256i v) {
+    __m128i s = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(1, 0, 3, 2)));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(s);
+}
+#endif
+
+/*
+ * n must be a multiple of NNQ8_ALIGN. Both operands are kept in [-127, 127],
+ * so |a| * sign(b, a) fits the u8 x s8 instructions without saturating.
+ */
+int32_t NNQ8_dot(const int8_t *a, const int8_t *b, unsigned int n) {
+#if defined(__AVX512VNNI__) && defined(__AVX512VL__)
+    __m256i acc = _mm256_setzero_si256();
+    for (unsigned int i = 0; i < n; i += 32) {
+        __m256i va = _mm256_loadu_si256((const __m256i *)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i *)(b + i));
+        acc = _mm256_dpbusd_epi32(acc, _mm256_abs_epi8(va), _mm256_sign_epi8(vb, va));
+    }
+    return hsum_epi32(acc);
+#elif defined(__AVXVNNI__)
+    __m256i acc = _mm256_setzero_si256();
+    for (unsigned int i = 0; i < n; i += 32) {
+        __m256i va = _mm256_loadu_si256((const __m256i *)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i *)(b + i));
+        acc = _mm256_dpbusd_avx_epi32(acc, _mm256_abs_epi8(va), _mm256_sign_epi8(vb, va));
+    }
+    return hsum_epi32(acc);
+#elif defined(__AVX2__)
+    const __m256i ones = _mm256_set1_epi16(1);
+    __m256i acc = _mm256_setzero_si256();
+    for (unsigned int i = 0; i < n; i += 32) {
+        __m256i va = _mm256_loadu_si256((const __m256i *)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i *)(b + i));
+        __m256i prod = _mm256_maddubs_epi16(_mm256_abs_epi8(va), _mm256_sign_epi8(vb, va));
+        acc = _mm256_add_epi32(acc, _mm256_madd_epi16(prod, ones));
+    }
+    return hsum_epi32(acc);
+#elif defined(__SSSE3__)
+    const __m128i ones = _mm_set1_epi16(1);
+    __m128i acc = _mm_setzero_si128();
+    for (unsigned int i = 0; i < n; i += 16) {
+        __m128i va = _mm_loadu_si128((const __m128i *)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i *)(b + i));
+        __m128i prod = _mm_maddubs_epi16(_mm_abs_epi8(va), _mm_sign_epi8(vb, va));
+        acc = _mm_add_epi32(acc, _mm_madd_epi16(prod, ones));
+    }
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(acc);
+#else
+    int32_t acc = 0;
+    for (unsigned int i = 0; i < n; i++) {
+        acc += (int32_t)a[i] * (int32_t)b[i];
+    }
+    return acc;
+#endif
+}
+
+const char *NNQ8_kernel_name(void) {
+#if defined(__AVX512VNNI__) && defined(__AVX512VL__)
+    return "avx512-vnni";
+#elif defined(__AVXVNNI__)
+    return "avx-vnni";
+#elif defined(__AVX2__)
+    return "avx2";
+#elif defined(__SSSE3__)
+    return "ssse3";
+#else
+    return "scalar";
+#endif
+}
+
+NNQ8_t *NNQ8_quantize(NN_t *nn) {
+    NNQ8_t *q = (NNQ8_t *)calloc(1, sizeof(NNQ8_t));
+    if (!q) return NULL;
+
+    q->numInputs = nn->numInputs;
+    q->numHidden = nn->numHidden;
+    q->numOutput = nn->numOutput;
+    q->strideInputs = pad_to_align(nn->numInputs);
+    q->strideHidden = pad_to_align(nn->numHidden);
+
+    q->weightsIH = (int8_t *)malloc((size_t)q->numHidden * q->strideInputs);
+    q->weightsHO = (int8_t *)malloc((size_t)q->numOutput * q->strideHidden);
+    q->biases = (double *)malloc(sizeof(double) * nn->numBiases);
+    q->qInputs = (int8_t *)calloc(q->strideInputs, 1);
+    q->qHidden = (int8_t *)calloc(q->strideHidden, 1);
+    q->hidden = (double *)calloc(q->numHidden, sizeof(double));
+    q->output = (double *)calloc(q->numOutput, sizeof(double));
+    q->hiddenActivations = (ActivationFunction *)malloc(q->numHidden * sizeof(ActivationFunction));
+    q->outputActivations = (ActivationFunction *)malloc(q->numOutput * sizeof(ActivationFunction));
+
+    if (!q->weightsIH || !q->weightsHO || !q->biases || !q->qInputs || !q->qHidden ||
+        !q->hidden || !q->output || !q->hiddenActivations || !q->outputActivations) {
+        fprintf(stderr, "Failed to allocate quantized network\n");
+        NNQ8_destroy(q);
+        return NULL;
+    }
+
+    NNQ8_requantize(q, nn);
+    return q;
+}
+
+void NNQ8_requantize(NNQ8_t *q, NN_t *nn) {
+    q->scaleIH = quantize_layer(q->weightsIH, nn->weights, q->numHidden, q->numInputs, q->strideInputs);
+    q->scaleHO = quantize_layer(q->weightsHO, &nn->weights[nn->numInputs * nn->numHidden], q->numOutput, q->numHidden, q->strideHidden);
+    memcpy(q->biases, nn->biases, sizeof(double) * nn->numBiases);
+    memcpy(q->hiddenActivations, nn->hiddenActivations, q->numHidden * sizeof(ActivationFunction));
+    memcpy(q->outputActivations, nn->outputActivations, q->numOutput * sizeof(ActivationFunction));
+}
+
+void NNQ8_destroy(NNQ8_t *q) {
+    if (!q) return;
+    free(q->weightsIH);
+    free(q->weightsHO);
+    free(q->biases);
+    free(q->qInputs);
+    free(q->qHidden);
+    free(q->hidden);
+    free(q->output);
+    free(q->hiddenActivations);
+    free(q->outputActivations);
+    free(q);
+}
+
+void forwardQ8(NNQ8_t *q, const double *input) {
+    double inScale = quantize_activations(q->qInputs, input, q->numInputs) * q->scaleIH;
+    for (unsigned int i = 0; i < q->numHidden; i++) {
+        int32_t acc = NNQ8_dot(&q->weightsIH[(size_t)i * q->strideInputs], q->qInputs, q->strideInputs);
+        q->hidden[i] = q->hiddenActivations[i](q->biases[i] + acc * inScale);
+    }
+
+    double hiddenScale = quantize_activations(q->qHidden, q->hidden, q->numHidden) * q->scaleHO;
+    for (unsigned int i = 0; i < q->numOutput; i++) {
+        int32_t acc = NNQ8_dot(&q->weightsHO[(size_t)i * q->strideHidden], q->qHidden, q->strideHidden);
+        q->output[i] = q->outputActivations[i](q->biases[q->numHidden + i] + acc * hiddenScale);
+    }
+}
+
+static unsigned int argmax(const double *xs, unsigned int n) {
+    unsigned int best = 0;
+    for (unsigned int i = 1; i < n; i++) {
+        if (xs[i] > xs[best]) best = i;
+    }
+    return best;
+}
+
+NNQ8_Report NNQ8_compare(NN_t *nn, NNQ8_t *q, double *inputs, int num_samples) {
+    NNQ8_Report report = {0.0, 0.0, 0.0};
+    size_t count = 0;
+    int agree = 0;
+
+    for (int s = 0; s < num_samples; s++) {
+        double *input = inputs + (size_t)s * nn->numInputs;
+        forward(nn, input);
+        forwardQ8(q, input);
+        for (unsigned int i = 0; i < nn->numOutput; i++) {
+            double delta = fabs(nn->output[i] - q->output[i]);
+            report.meanAbsDelta += delta;
+            if (delta > report.maxAbsDelta) report.maxAbsDelta = delta;
+            count++;
+        }
+        agree += argmax(nn->output, nn->numOutput) == argmax(q->output, q->numOutput);
+    }
+
+    if (count > 0) {
+        report.meanAbsDelta /= (double)count;
+        report.argmaxAgreement = (double)agree / num_samples;
+    }
+    printf("Quantized [%s]: mean |delta| = %.6f, max |delta| = %.6f, argmax agreement = %.2f%%\n",
+           NNQ8_kernel_name(), report.meanAbsDelta, report.maxAbsDelta, report.argmaxAgreement * 100.0);
+    return report;
+}
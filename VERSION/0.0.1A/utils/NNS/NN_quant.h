@@ -0,0 +1,49 @@
+#ifndef NN_QUANT_H
+#define NN_QUANT_H
+
+#include <stdint.h>
+#include "NN.h"
+
+/*
+ * Inference-only int8 copy of an NN_t. Weights are quantized symmetrically
+ * with one scale per layer; activations are quantized per call. Rows are
+ * zero-padded to NNQ8_ALIGN so the dot kernels never need a tail loop.
+ */
+#define NNQ8_ALIGN 32
+
+typedef struct {
+  unsigned int numInputs;
+  unsigned int numHidden;
+  unsigned int numOutput;
+  unsigned int strideInputs;
+  unsigned int strideHidden;
+  int8_t *weightsIH;
+  int8_t *weightsHO;
+  float scaleIH;
+  float scaleHO;
+  double *biases;
+  int8_t *qInputs;
+  int8_t *qHidden;
+  double *hidden;
+  double *output;
+  ActivationFunction *hiddenActivations;
+  ActivationFunction *outputActivations;
+} NNQ8_t;
+
+typedef struct {
+  double meanAbsDelta;
+  double maxAbsDelta;
+  double argmaxAgreement;
+} NNQ8_Report;
+
+NNQ8_t *NNQ8_quantize(NN_t *nn);
+void NNQ8_requantize(NNQ8_t *q, NN_t *nn);
+void NNQ8_destroy(NNQ8_t *q);
+
+void forwardQ8(NNQ8_t *q, const double *input);
+int32_t NNQ8_dot(const int8_t *a, const int8_t *b, unsigned int n);
+const char *NNQ8_kernel_name(void);
+
+NNQ8_Report NNQ8_compare(NN_t *nn, NNQ8_t *q, double *inputs, int num_samples);
+
+#endif
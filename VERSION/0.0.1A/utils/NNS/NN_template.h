@@ -0,0 +1,103 @@
+/*
+ * Element-type template for NN_t. Included once per precision by NN.h with
+ * NN_REAL (element type), NN_SUFFIX (name suffix) and NN_SQRT/NN_EXP/NN_LOG
+ * defined:
+ *
+ *   NN_REAL double, NN_SUFFIX <empty> -> NN_t,   NN_create,   forward,   NNSparseInput,   ...
+ *   NN_REAL float,  NN_SUFFIX 32      -> NN32_t, NN32_create, forward32, NNSparseInput32, ...
+ *
+ * No include guard on purpose.
+ */
+
+#ifndef NN_REAL
+#error "NN_template.h needs NN_REAL and NN_SUFFIX"
+#endif
+
+#define NN_CAT_(a, b) a##b
+#define NN_CAT(a, b) NN_CAT_(a, b)
+#define NN_PREFIX NN_CAT(NN, NN_SUFFIX)
+#define NN_TYPE NN_CAT(NN_PREFIX, _t)
+#define NN_API(name) NN_CAT(NN_PREFIX, name)
+#define NN_FN(name) NN_CAT(name, NN_SUFFIX)
+#define NN_ACTIVATION NN_CAT(ActivationFunction, NN_SUFFIX)
+#define NN_SPARSE_INPUT NN_CAT(NNSparseInput, NN_SUFFIX)
+
+typedef NN_REAL (*NN_ACTIVATION)(NN_REAL);
+
+typedef struct {
+  unsigned int index;
+  NN_REAL value;
+} NN_SPARSE_INPUT;
+
+typedef struct {
+  unsigned int numInputs;
+  NN_REAL *inputs;
+  unsigned int numHidden;
+  NN_REAL *hidden;
+  unsigned int numOutput;
+  NN_REAL *output;
+  unsigned int numWeights;
+  NN_REAL *weights;
+  NN_REAL *weightsO;
+  unsigned int numBiases;
+  NN_REAL *biases;
+  NN_REAL *biasesO;
+  unsigned int numParams;
+  NN_REAL *params;     /* weights | biases, one block */
+  NN_REAL learningRate;
+  NN_REAL momentum;
+  NN_REAL error;
+  NN_REAL *gradient;   /* numParams, same layout as params */
+  NN_REAL *gradientO;  /* second moment for Adam/RMSProp; weightsO | biasesO hold the first */
+  NN_REAL *workspace;
+  NNOptimizer optimizer;
+  NNLoss loss;
+  void *mapping;       /* set when the network was loaded from a model file */
+  size_t mappingSize;
+  int ownsParams;      /* 0 while params point into mapping or a population */
+  NN_ACTIVATION *hiddenActivations;
+  NN_ACTIVATION *outputActivations;
+  NN_ACTIVATION *hiddenActivationDerivatives;
+  NN_ACTIVATION *outputActivationDerivatives;
+} NN_TYPE;
+
+NN_TYPE *NN_API(_create)(unsigned int numInputs, unsigned int numHidden, unsigned int numOutput, NN_ACTIVATION *hiddenActivations, NN_ACTIVATION *hiddenActivationDerivatives, NN_ACTIVATION *outputActivations, NN_ACTIVATION *outputActivationDerivatives, NN_REAL learningRate, NN_REAL momentum);
+
+void NN_API(_destroy)(NN_TYPE *nn);
+
+void NN_API(_dense)(const NN_REAL *weights, const NN_REAL *biases, const NN_REAL *x, NN_REAL *y, unsigned int rows, unsigned int cols);
+void NN_API(_infer)(const NN_TYPE *nn, const NN_REAL *input, NN_REAL *hidden, NN_REAL *output);
+unsigned int NN_API(_workspace_size)(const NN_TYPE *nn);
+NN_REAL NN_FN(linear)(NN_REAL x);
+NN_REAL NN_FN(linear_derivative)(NN_REAL x);
+void NN_API(_set_loss)(NN_TYPE *nn, NNLoss loss);
+unsigned int NN_API(_argmax)(const NN_REAL *x, unsigned int n);
+NN_REAL NN_API(_softmax)(const NN_REAL *logits, NN_REAL *probs, unsigned int n);
+NN_REAL NN_API(_softmax_cross_entropy)(const NN_REAL *logits, const NN_REAL *target, NN_REAL *delta, unsigned int n);
+
+NN_REAL NN_API(_gradients)(const NN_TYPE *nn, const NN_REAL *input, const NN_REAL *target, NN_REAL *workspace, NN_REAL *grad);
+NN_REAL NN_API(_backward)(const NN_TYPE *nn, const NN_REAL *input, const NN_REAL *hidden, const NN_REAL *output, const NN_REAL *target, NN_REAL *errors, NN_REAL *grad, int accumulate);
+void NN_API(_set_optimizer)(NN_TYPE *nn, NNOptimizerKind kind);
+void NN_API(_apply_gradients)(NN_TYPE *nn, const NN_REAL *grad, NN_REAL scale);
+void NN_FN(forward)(NN_TYPE *nn, NN_REAL *input);
+void NN_FN(backprop)(NN_TYPE *nn, NN_REAL *target);
+
+void NN_API(_sparse_dense)(const NN_REAL *weights, const NN_REAL *biases, const NN_SPARSE_INPUT *entries, unsigned int count, NN_REAL *y, unsigned int rows, unsigned int cols);
+void NN_API(_infer_sparse)(const NN_TYPE *nn, const NN_SPARSE_INPUT *entries, unsigned int count, NN_REAL *hidden, NN_REAL *output);
+void NN_FN(forward_sparse)(NN_TYPE *nn, const NN_SPARSE_INPUT *entries, unsigned int count);
+void NN_FN(backprop_sparse)(NN_TYPE *nn, const NN_SPARSE_INPUT *entries, unsigned int count, NN_REAL *target);
+NN_REAL *NN_FN(train)(NN_TYPE *nn, NN_REAL *input, NN_REAL *target, int num_samples, int num_epochs);
+void NN_FN(test)(NN_TYPE *nn, NN_REAL *inputs, NN_REAL *targets, int num_samples);
+
+#ifdef NN_TEMPLATE_IMPL
+#include "NN_template.inc"
+#endif
+
+#undef NN_SPARSE_INPUT
+#undef NN_ACTIVATION
+#undef NN_FN
+#undef NN_API
+#undef NN_TYPE
+#undef NN_PREFIX
+#undef NN_CAT
+#undef NN_CAT_
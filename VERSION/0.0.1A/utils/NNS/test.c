@@ -25,7 +25,7 @@ int main(void) {
         sigmoid_derivatives[i] = sigmoid_derivative;
     }
     for (int i = 0; i < 4; i++) {
-        tanh_activations[i] = tanh;
+        tanh_activations[i] = tanh_activation;
         tanh_derivatives[i] = tanh_derivative;
     }
 
@@ -0,0 +1,175 @@
+#include <math.h>
+#include <stdatomic.h>
+#include <string.h>
+#include "rng.h"
+
+#define RNG_CHUNK 64
+
+static inline uint64_t rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+static uint64_t splitmix64(uint64_t *state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/* Streams start SplitMix64 at points spaced by a different odd constant. */
+void rngSeed(Rng *rng, uint64_t seed, uint64_t stream) {
+    uint64_t state = seed ^ (stream * 0xD1B54A32D192ED03ULL);
+    splitmix64(&state);
+    for (int w = 0; w < 4; w++) {
+        for (int l = 0; l < RNG_LANES; l++) {
+            rng->s[w][l] = splitmix64(&state);
+        }
+    }
+    rng->available = 0;
+}
+
+/* Advances every lane once and writes one output per lane. */
+static void rngStep(Rng *rng, uint64_t *restrict out) {
+    uint64_t *restrict s0 = rng->s[0];
+    uint64_t *restrict s1 = rng->s[1];
+    uint64_t *restrict s2 = rng->s[2];
+    uint64_t *restrict s3 = rng->s[3];
+    for (int l = 0; l < RNG_LANES; l++) {
+        out[l] = rotl(s1[l] * 5, 7) * 9;
+        uint64_t t = s1[l] << 17;
+        s2[l] ^= s0[l];
+        s3[l] ^= s1[l];
+        s1[l] ^= s2[l];
+        s0[l] ^= s3[l];
+        s2[l] ^= t;
+        s3[l] = rotl(s3[l], 45);
+    }
+}
+
+uint64_t rngNext(Rng *rng) {
+    if (rng->available == 0) {
+        rngStep(rng, rng->buffer);
+        rng->available = RNG_LANES;
+    }
+    return rng->buffer[RNG_LANES - rng->available--];
+}
+
+/* Lemire's multiply-shift with rejection; unbiased for any bound > 0. */
+uint32_t rngBelow(Rng *rng, uint32_t bound) {
+    uint64_t m = (rngNext(rng) >> 32) * bound;
+    uint32_t low = (uint32_t)m;
+    if (low < bound) {
+        uint32_t threshold = -bound % bound;
+        while (low < threshold) {
+            m = (rngNext(rng) >> 32) * bound;
+            low = (uint32_t)m;
+        }
+    }
+    return (uint32_t)(m >> 32);
+}
+
+/* [0, 1) from the top 52 bits, built directly in the mantissa. */
+static inline double toUniform(uint64_t bits) {
+    double d;
+    bits = (bits >> 12) | 0x3FF0000000000000ULL;
+    memcpy(&d, &bits, sizeof(d));
+    return d - 1.0;
+}
+
+double rngUniform(Rng *rng) {
+    return toUniform(rngNext(rng));
+}
+
+double rngNormal(Rng *rng) {
+    double u1 = 1.0 - rngUniform(rng);
+    double u2 = rngUniform(rng);
+    return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+void rngFill(Rng *rng, uint64_t *out, size_t n) {
+    size_t i = 0;
+    while (i < n && rng->available) {
+        out[i++] = rng->buffer[RNG_LANES - rng->available--];
+    }
+    for (; i + RNG_LANES <= n; i += RNG_LANES) {
+        rngStep(rng, out + i);
+    }
+    while (i < n) {
+        out[i++] = rngNext(rng);
+    }
+}
+
+void rngUniformBatch(Rng *rng, double *out, size_t n) {
+    uint64_t bits[RNG_CHUNK];
+    for (size_t i = 0; i < n; i += RNG_CHUNK) {
+        size_t count = n - i < RNG_CHUNK ? n - i : RNG_CHUNK;
+        rngFill(rng, bits, count);
+        for (size_t j = 0; j < count; j++) {
+            out[i + j] = toUniform(bits[j]);
+        }
+    }
+}
+
+/* Box-Muller over whole chunks, both outputs of each pair are kept. */
+void rngNormalBatch(Rng *rng, double *out, size_t n) {
+    double u[RNG_CHUNK];
+    for (size_t i = 0; i < n; i += RNG_CHUNK) {
+        size_t count = n - i < RNG_CHUNK ? n - i : RNG_CHUNK;
+        size_t pairs = (count + 1) / 2;
+        rngUniformBatch(rng, u, 2 * pairs);
+        double *dst = out + i;
+        for (size_t j = 0; j < count / 2; j++) {
+            double r = sqrt(-2.0 * log(1.0 - u[2 * j]));
+            double theta = 2.0 * M_PI * u[2 * j + 1];
+            dst[2 * j] = r * cos(theta);
+            dst[2 * j + 1] = r * sin(theta);
+        }
+        if (count & 1) {
+            dst[count - 1] = sqrt(-2.0 * log(1.0 - u[count - 1])) * cos(2.0 * M_PI * u[count]);
+        }
+    }
+}
+
+/*
+ * Irwin-Hall approximation: four 16-bit uniforms per draw, centred on their
+ * mean of 4 * 65535 / 2 and rescaled to unit variance. No transcendental
+ * calls, so it vectorizes; tails stop at +-2*sqrt(3), which is fine for
+ * noise such as mutation.
+ */
+void rngNormalFastBatch(Rng *rng, double *out, size_t n) {
+    uint64_t bits[RNG_CHUNK];
+    const double scale = 1.7320508075688772 / 65536.0;
+    for (size_t i = 0; i < n; i += RNG_CHUNK) {
+        size_t count = n - i < RNG_CHUNK ? n - i : RNG_CHUNK;
+        rngFill(rng, bits, count);
+        for (size_t j = 0; j < count; j++) {
+            uint64_t b = bits[j];
+            int32_t sum = (int32_t)(b & 0xFFFF) + (int32_t)((b >> 16) & 0xFFFF) +
+                          (int32_t)((b >> 32) & 0xFFFF) + (int32_t)(b >> 48) - 2 * 65535;
+            out[i + j] = (double)sum * scale;
+        }
+    }
+}
+
+static uint64_t globalSeed = 0x853C49E6748FEA9BULL;
+static atomic_uint seedGeneration = 1;
+static atomic_ullong nextThreadStream = 0;
+static _Thread_local Rng threadRng;
+static _Thread_local unsigned int threadRngGeneration = 0;
+
+void rngSetSeed(uint64_t seed) {
+    globalSeed = seed;
+    atomic_store(&nextThreadStream, 0);
+    atomic_fetch_add(&seedGeneration, 1);
+}
+
+/* Thread streams live in the top half of the stream space. */
+Rng *rngThread(void) {
+    unsigned int generation = atomic_load(&seedGeneration);
+    if (threadRngGeneration != generation) {
+        uint64_t stream = atomic_fetch_add(&nextThreadStream, 1);
+        rngSeed(&threadRng, globalSeed, stream | 0x8000000000000000ULL);
+        threadRngGeneration = generation;
+    }
+    return &threadRng;
+}
@@ -0,0 +1,41 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * xoshiro256** with RNG_LANES independent lanes stepped together, so bulk
+ * draws vectorize and scalar draws are served from a small buffer. A
+ * generator is fully determined by (seed, stream): give each agent or
+ * worker its own stream and results do not depend on thread scheduling.
+ */
+#define RNG_LANES 4
+
+typedef struct {
+    uint64_t s[4][RNG_LANES];
+    uint64_t buffer[RNG_LANES];
+    unsigned int available;
+} Rng;
+
+void rngSeed(Rng *rng, uint64_t seed, uint64_t stream);
+
+uint64_t rngNext(Rng *rng);
+uint32_t rngBelow(Rng *rng, uint32_t bound);
+double rngUniform(Rng *rng);
+double rngNormal(Rng *rng);
+
+void rngFill(Rng *rng, uint64_t *out, size_t n);
+void rngUniformBatch(Rng *rng, double *out, size_t n);
+void rngNormalBatch(Rng *rng, double *out, size_t n);
+void rngNormalFastBatch(Rng *rng, double *out, size_t n);
+
+/*
+ * Per-thread generator for code that has no stream of its own. Threads are
+ * given streams in the order they first call rngThread, all derived from the
+ * seed passed to rngSetSeed (call it before starting threads).
+ */
+void rngSetSeed(uint64_t seed);
+Rng *rngThread(void);
+
+#endif
@@ -0,0 +1,39 @@
+#include "proximity.h"
+
+/*
+ * Tests one point against count packed positions and sets bit i of mask
+ * (PROXIMITY_WORDS(count) words) when position i lies within the radius.
+ * groups is optional: when given, only positions tagged group can hit.
+ * Returns the number of hits. The inner loop is branch-free over a block
+ * of 64 lanes so the compiler can vectorize it.
+ */
+size_t proximityMask(int x, int y, const uint8_t *restrict xs, const uint8_t *restrict ys, const uint32_t *restrict groups, uint32_t group,
+                     size_t count, int width, int height, int radiusSquared, uint64_t *restrict mask) {
+    size_t hits = 0;
+    for (size_t base = 0; base < count; base += 64) {
+        size_t n = count - base < 64 ? count - base : 64;
+        uint8_t hit[64];
+        for (size_t i = 0; i < n; i++) {
+            int dx = (int)xs[base + i] - x;
+            int dy = (int)ys[base + i] - y;
+            dx = dx < 0 ? -dx : dx;
+            dy = dy < 0 ? -dy : dy;
+            dx = dx < width - dx ? dx : width - dx;
+            dy = dy < height - dy ? dy : height - dy;
+            hit[i] = dx * dx + dy * dy <= radiusSquared;
+        }
+        if (groups) {
+            for (size_t i = 0; i < n; i++) {
+                hit[i] &= groups[base + i] == group;
+            }
+        }
+
+        uint64_t word = 0;
+        for (size_t i = 0; i < n; i++) {
+            word |= (uint64_t)hit[i] << i;
+        }
+        mask[base / 64] = word;
+        hits += (size_t)__builtin_popcountll(word);
+    }
+    return hits;
+}
@@ -0,0 +1,28 @@
+#ifndef PROXIMITY_H
+#define PROXIMITY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define PROXIMITY_WORDS(count) (((count) + 63) / 64)
+
+/*
+ * Distance tests on a torus of width x height cells, in integers and
+ * without square roots: callers compare squared distances against a
+ * squared radius. Coordinates on each axis must lie within one period.
+ */
+static inline int proximityWrap(int d, int period) {
+  d = d < 0 ? -d : d;
+  return d < period - d ? d : period - d;
+}
+
+static inline int proximitySquared(int ax, int ay, int bx, int by, int width, int height) {
+  int dx = proximityWrap(ax - bx, width);
+  int dy = proximityWrap(ay - by, height);
+  return dx * dx + dy * dy;
+}
+
+size_t proximityMask(int x, int y, const uint8_t *xs, const uint8_t *ys, const uint32_t *groups, uint32_t group,
+                     size_t count, int width, int height, int radiusSquared, uint64_t *mask);
+
+#endif
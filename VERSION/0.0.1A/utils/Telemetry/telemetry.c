@@ -0,0 +1,121 @@
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "telemetry.h"
+
+#define TELEMETRY_FLUSH_MS 100
+
+static void writeRecord(Telemetry *telemetry, const TelemetryRecord *r) {
+    if (telemetry->format == TELEMETRY_BINARY) {
+        fwrite(r, sizeof(TelemetryRecord), 1, telemetry->file);
+    } else {
+        fprintf(telemetry->file, "%llu,%u,%u,%u,%u,%u,%u,%.3f,%.3f,%.3f,%.3f,%.1f\n",
+                (unsigned long long)r->tick, r->source, r->generation, r->predators, r->preys,
+                r->catches, r->foodEaten, r->predatorBest, r->predatorMean, r->preyBest, r->preyMean,
+                r->ticksPerSecond);
+    }
+}
+
+static size_t drain(Telemetry *telemetry) {
+    TelemetryRecord record;
+    size_t drained = 0;
+    for (unsigned int p = 0; p < telemetry->numProducers; p++) {
+        while (ringBufferPop(telemetry->rings[p], &record)) {
+            writeRecord(telemetry, &record);
+            drained++;
+        }
+    }
+    atomic_fetch_add_explicit(&telemetry->written, drained, memory_order_relaxed);
+    return drained;
+}
+
+static void *flushLoop(void *arg) {
+    Telemetry *telemetry = (Telemetry *)arg;
+    struct timespec pause = {0, TELEMETRY_FLUSH_MS * 1000000L};
+    while (!atomic_load_explicit(&telemetry->stop, memory_order_acquire)) {
+        if (drain(telemetry) > 0) {
+            fflush(telemetry->file);
+        }
+        nanosleep(&pause, NULL);
+    }
+    drain(telemetry);
+    fflush(telemetry->file);
+    return NULL;
+}
+
+/* capacity is records buffered per producer between flushes. */
+Telemetry *telemetryOpen(const char *path, TelemetryFormat format, unsigned int numProducers, size_t capacity) {
+    if (!path || numProducers == 0) return NULL;
+
+    Telemetry *telemetry = (Telemetry *)calloc(1, sizeof(Telemetry));
+    if (!telemetry) return NULL;
+    telemetry->format = format;
+    telemetry->numProducers = numProducers;
+    atomic_init(&telemetry->stop, 0);
+    atomic_init(&telemetry->written, 0);
+    atomic_init(&telemetry->dropped, 0);
+
+    telemetry->file = fopen(path, format == TELEMETRY_BINARY ? "wb" : "w");
+    telemetry->rings = (RingBuffer **)calloc(numProducers, sizeof(RingBuffer *));
+    if (!telemetry->file || !telemetry->rings) {
+        fprintf(stderr, "Failed to open telemetry file %s\n", path);
+        telemetryClose(telemetry);
+        return NULL;
+    }
+    for (unsigned int p = 0; p < numProducers; p++) {
+        telemetry->rings[p] = ringBufferCreate(capacity, sizeof(TelemetryRecord));
+        if (!telemetry->rings[p]) {
+            telemetryClose(telemetry);
+            return NULL;
+        }
+    }
+
+    if (format == TELEMETRY_BINARY) {
+        uint32_t header[2] = {TELEMETRY_MAGIC, (uint32_t)sizeof(TelemetryRecord)};
+        fwrite(header, sizeof(header), 1, telemetry->file);
+    } else {
+        fprintf(telemetry->file, "tick,source,generation,predators,preys,catches,food_eaten,"
+                                 "predator_best,predator_mean,prey_best,prey_mean,ticks_per_second\n");
+    }
+    fflush(telemetry->file);
+
+    if (pthread_create(&telemetry->flusher, NULL, flushLoop, telemetry) != 0) {
+        fprintf(stderr, "Failed to start telemetry flusher\n");
+        telemetryClose(telemetry);
+        return NULL;
+    }
+    telemetry->started = 1;
+    return telemetry;
+}
+
+/* Flushes every record still queued, then closes the file. */
+void telemetryClose(Telemetry *telemetry) {
+    if (!telemetry) return;
+    if (telemetry->started) {
+        atomic_store_explicit(&telemetry->stop, 1, memory_order_release);
+        pthread_join(telemetry->flusher, NULL);
+    }
+    size_t dropped = atomic_load(&telemetry->dropped);
+    if (dropped > 0) {
+        fprintf(stderr, "Telemetry dropped %zu records\n", dropped);
+    }
+    if (telemetry->rings) {
+        for (unsigned int p = 0; p < telemetry->numProducers; p++) {
+            ringBufferDestroy(telemetry->rings[p]);
+        }
+        free(telemetry->rings);
+    }
+    if (telemetry->file) {
+        fclose(telemetry->file);
+    }
+    free(telemetry);
+}
+
+/* Call only from the producer's own thread. Returns 0, or -1 when the record was dropped. */
+int telemetryRecord(Telemetry *telemetry, unsigned int producer, const TelemetryRecord *record) {
+    if (producer >= telemetry->numProducers || ringBufferPush(telemetry->rings[producer], record) != 0) {
+        atomic_fetch_add_explicit(&telemetry->dropped, 1, memory_order_relaxed);
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,55 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "../Concurrency/ring_buffer.h"
+
+#define TELEMETRY_MAGIC 0x4D4C4554u /* "TELM" */
+
+typedef enum {
+  TELEMETRY_CSV,
+  TELEMETRY_BINARY /* TELEMETRY_MAGIC, sizeof(TelemetryRecord), then raw records */
+} TelemetryFormat;
+
+typedef struct {
+  uint64_t tick;
+  uint32_t source;          /* island or evaluator that produced the record */
+  uint32_t generation;
+  uint32_t predators;
+  uint32_t preys;
+  uint32_t catches;         /* since the previous record of this source */
+  uint32_t foodEaten;
+  double predatorBest;
+  double predatorMean;
+  double preyBest;
+  double preyMean;
+  double ticksPerSecond;
+} TelemetryRecord;
+
+/*
+ * Run statistics sink. Every producer thread owns one ring, so recording is
+ * a copy into memory no other producer touches; a background thread drains
+ * the rings and does all formatting and file I/O. A full ring drops the
+ * record rather than stall the producer.
+ */
+typedef struct {
+  FILE *file;
+  TelemetryFormat format;
+  RingBuffer **rings;
+  unsigned int numProducers;
+  pthread_t flusher;
+  int started;
+  atomic_int stop;
+  atomic_size_t written;
+  atomic_size_t dropped;
+} Telemetry;
+
+Telemetry *telemetryOpen(const char *path, TelemetryFormat format, unsigned int numProducers, size_t capacity);
+void telemetryClose(Telemetry *telemetry);
+
+int telemetryRecord(Telemetry *telemetry, unsigned int producer, const TelemetryRecord *record);
+
+#endif
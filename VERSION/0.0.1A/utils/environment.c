@@ -1,4 +1,5 @@
 #include "environment.h"
+#include "Random/rng.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -324,7 +325,8 @@ void movePlayer(Canvas *canvas, Entity *player, char dir) {
 }
 
 void moveEnemy(Canvas *canvas, Entity *enemy) {
-  moveEntity(canvas, enemy, (Pos){(rand() % 3) - 1, (rand() % 3) - 1}); 
+  Rng *rng = rngThread();
+  moveEntity(canvas, enemy, (Pos){(int)rngBelow(rng, 3) - 1, (int)rngBelow(rng, 3) - 1});
 }
 
 void entityThreadFunc(EntityThreadArgs *args) {